@@ -0,0 +1,393 @@
+#include <Interpolation.hpp>
+#include <ThreadPool.hpp>
+#include "include/Benchmark.hpp"
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifndef INTP_BENCHMARK_VERSION
+#define INTP_BENCHMARK_VERSION "unknown"
+#endif
+#ifndef INTP_BENCHMARK_BUILD_TYPE
+#define INTP_BENCHMARK_BUILD_TYPE "unknown"
+#endif
+
+using namespace intp;
+
+namespace {
+
+// All random numbers are drawn from generators seeded with this value, so
+// that every run benchmarks the same data and the same points.
+constexpr unsigned int seed = 42;
+
+struct Config {
+    std::size_t order;
+    std::size_t grid;
+    bool periodic;
+    bool uniform;
+};
+
+/**
+ * @brief Data to be interpolated on [0, 1]^D, with nonuniform coordinates used
+ * if the config requires.
+ *
+ */
+template <std::size_t D>
+struct Problem {
+    Mesh<double, D> mesh;
+    std::array<std::vector<double>, D> coords;
+
+    Problem(std::size_t grid, std::mt19937& gen) : mesh(grid) {
+        std::uniform_real_distribution<> val_dist(-1, 1);
+        for (std::size_t i = 0; i < mesh.size(); ++i) {
+            *(mesh.data() + i) = val_dist(gen);
+        }
+        // jittered grid, ends are fixed at 0 and 1
+        std::uniform_real_distribution<> jitter(-.3, .3);
+        const double dx = 1. / static_cast<double>(grid - 1);
+        for (auto& c : coords) {
+            c.resize(grid);
+            for (std::size_t i = 0; i < grid; ++i) {
+                c[i] = (static_cast<double>(i) +
+                        (i == 0 || i + 1 == grid ? 0. : jitter(gen))) *
+                       dx;
+            }
+        }
+    }
+};
+
+/**
+ * @brief Interpolation template on [0, 1]^D uniform grid
+ *
+ */
+template <std::size_t D, std::size_t... I>
+InterpolationFunctionTemplate<double, D> make_template(
+    const Config& cfg,
+    const Problem<D>& p,
+    util::index_sequence<I...>) {
+    std::array<bool, D> periodicity;
+    periodicity.fill(cfg.periodic);
+    return InterpolationFunctionTemplate<double, D>(
+        cfg.order, periodicity, p.mesh.dimension(),
+        std::make_pair(0., (void(I), 1.))...);
+}
+
+template <std::size_t D, std::size_t... I>
+InterpolationFunction<double, D> fit(const Config& cfg,
+                                     const Problem<D>& p,
+                                     util::index_sequence<I...>) {
+    std::array<bool, D> periodicity;
+    periodicity.fill(cfg.periodic);
+    // (void(I), 1.) expands a range pair for each dimension
+    return cfg.uniform ? InterpolationFunction<double, D>(
+                             cfg.order, periodicity, p.mesh,
+                             std::make_pair(0., (void(I), 1.))...)
+                       : InterpolationFunction<double, D>(
+                             cfg.order, periodicity, p.mesh,
+                             std::make_pair(p.coords[I].begin(),
+                                            p.coords[I].end())...);
+}
+
+/**
+ * @brief Generate evaluation points in [0, 1]^D. Random points are
+ * independent of each other, while coherent points form a random walk with
+ * step less than half of a grid cell, resembling particle trajectories.
+ *
+ */
+template <std::size_t D>
+std::vector<std::array<double, D>> make_points(bool coherent,
+                                               std::size_t n,
+                                               std::size_t grid) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> dist(0, 1);
+    std::uniform_real_distribution<> step(-.5 / static_cast<double>(grid),
+                                          .5 / static_cast<double>(grid));
+    std::vector<std::array<double, D>> pts(n);
+    for (auto& x : pts[0]) { x = dist(gen); }
+    for (std::size_t i = 1; i < n; ++i) {
+        for (std::size_t d = 0; d < D; ++d) {
+            if (!coherent) {
+                pts[i][d] = dist(gen);
+                continue;
+            }
+            double x = pts[i - 1][d] + step(gen);
+            // reflect at boundaries
+            x = x < 0 ? -x : x > 1 ? 2 - x : x;
+            pts[i][d] = x;
+        }
+    }
+    return pts;
+}
+
+/**
+ * @brief Check that the fitted function passes through the first few grid
+ * points.
+ *
+ */
+template <std::size_t D>
+bool check_fit(const InterpolationFunction<double, D>& f,
+               const Config& cfg,
+               const Problem<D>& p) {
+    const std::size_t check_num = std::min<std::size_t>(16, p.mesh.size());
+    for (std::size_t i = 0; i < check_num; ++i) {
+        const auto ind = p.mesh.dimension().dimwise_indices(i);
+        std::array<double, D> x;
+        bool skip = false;
+        for (std::size_t d = 0; d < D; ++d) {
+            // the last point of periodic dimension is discarded
+            skip = skip || (cfg.periodic && ind[d] + 1 == cfg.grid);
+            x[d] = cfg.uniform ? static_cast<double>(ind[d]) /
+                                     static_cast<double>(cfg.grid - 1)
+                               : p.coords[d][ind[d]];
+        }
+        if (!skip && std::abs(f(x) - *(p.mesh.data() + i)) > 1e-8) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::pair<std::string, std::string>> params_of(
+    std::size_t dim,
+    const Config& cfg) {
+    return {{"dim", std::to_string(dim)},
+            {"order", std::to_string(cfg.order)},
+            {"grid", std::to_string(cfg.grid)},
+            {"periodic", cfg.periodic ? "1" : "0"},
+            {"uniform", cfg.uniform ? "1" : "0"}};
+}
+
+/**
+ * @brief Inverse of monotone 1D function, in batch.
+ *
+ */
+void bench_inverse(BenchmarkRunner& runner,
+                   const Config& cfg,
+                   std::size_t point_num) {
+    if (cfg.periodic) { return; }
+    std::vector<double> vals(cfg.grid);
+    for (std::size_t i = 0; i < cfg.grid; ++i) {
+        const double x =
+            static_cast<double>(i) / static_cast<double>(cfg.grid - 1);
+        vals[i] = x + .1 * std::sin(x);
+    }
+    const InterpolationFunction1D<> f(std::make_pair(0., 1.),
+                                      util::get_range(vals), cfg.order);
+    for (bool sorted : {false, true}) {
+        auto ys = make_points<1>(sorted, point_num, cfg.grid);
+        std::vector<double> ys_flat, xs(point_num);
+        for (auto& y : ys) { ys_flat.push_back(y[0] * vals.back()); }
+        if (sorted) { std::sort(ys_flat.begin(), ys_flat.end()); }
+        auto params = params_of(1, cfg);
+        params.emplace_back("points", sorted ? "sorted" : "random");
+        runner.run("inverse_batch", params, point_num,
+                   2 * sizeof(double) + (cfg.order + 1) * sizeof(double),
+                   [&]() {
+                       f.inverse(ys_flat.begin(), ys_flat.end(), xs.begin());
+                       do_not_optimize(xs.back());
+                   });
+    }
+}
+
+template <std::size_t D>
+int bench_dim(BenchmarkRunner& runner,
+              const std::vector<std::size_t>& orders,
+              const std::vector<std::size_t>& grids,
+              std::size_t point_num) {
+    int status = 0;
+    for (auto grid : grids) {
+        std::mt19937 gen(seed);
+        const Problem<D> problem(grid, gen);
+        for (auto order : orders) {
+            for (bool periodic : {false, true}) {
+                for (bool uniform : {true, false}) {
+                    const Config cfg{order, grid, periodic, uniform};
+                    const auto params = params_of(D, cfg);
+
+                    // fit
+
+                    runner.run("fit", params, problem.mesh.size(),
+                               2 * sizeof(double), [&]() {
+                                   const auto f = fit(
+                                       cfg, problem,
+                                       util::make_index_sequence<D>{});
+                                   do_not_optimize(f.order);
+                               });
+
+                    // fitting with prebuilt template, by each engine and
+                    // sweep strategy
+                    if (uniform && !periodic) {
+                        auto t = make_template(cfg, problem,
+                                               util::make_index_sequence<D>{});
+                        for (auto engine : {FittingEngine::band_lu,
+                                            FittingEngine::recursive_filter}) {
+                            t.fitting_engine(engine);
+                            for (auto sweep : {SweepStrategy::strided,
+                                               SweepStrategy::tiled}) {
+                                t.sweep_strategy(sweep);
+                                auto interp_params = params;
+                                interp_params.emplace_back(
+                                    "engine", engine == FittingEngine::band_lu
+                                                  ? "band_lu"
+                                                  : "recursive_filter");
+                                interp_params.emplace_back(
+                                    "sweep", sweep == SweepStrategy::strided
+                                                 ? "strided"
+                                                 : "tiled");
+                                runner.run(
+                                    "interpolate", interp_params,
+                                    problem.mesh.size(), 2 * sizeof(double),
+                                    [&]() {
+                                        const auto f =
+                                            t.interpolate(problem.mesh);
+                                        do_not_optimize(f.order);
+                                    });
+                            }
+                        }
+                    }
+
+                    const auto f =
+                        fit(cfg, problem, util::make_index_sequence<D>{});
+                    if (!check_fit(f, cfg, problem)) {
+                        std::cout << "Fitting check failed for "
+                                  << BenchmarkResult{"fit", params, 0, 0, 0, 0}
+                                         .name()
+                                  << '\n';
+                        status = 1;
+                    }
+
+                    // evaluation paths, each on random and coherent points
+
+                    std::array<std::size_t, D> deri_orders;
+                    deri_orders.fill(1);
+                    const auto f_deri = f.differentiate(deri_orders);
+                    double local_size = 1;
+                    for (std::size_t d = 0; d < D; ++d) {
+                        local_size *= static_cast<double>(order + 1);
+                    }
+                    const double bytes_per_eval =
+                        (local_size + D) * sizeof(double);
+                    // pp-form takes (order+1)^D coefficients per cell, skip
+                    // it if that is too large
+                    const bool pp_affordable =
+                        local_size * static_cast<double>(problem.mesh.size()) <
+                        static_cast<double>(1 << 24);
+
+                    for (bool coherent : {false, true}) {
+                        const auto pts =
+                            make_points<D>(coherent, point_num, grid);
+                        auto eval_params = params;
+                        eval_params.emplace_back(
+                            "points", coherent ? "coherent" : "random");
+
+                        runner.run("evaluate", eval_params, point_num,
+                                   bytes_per_eval, [&]() {
+                                       double sum{};
+                                       for (auto& x : pts) { sum += f(x); }
+                                       do_not_optimize(sum);
+                                   });
+                        std::vector<double> vals(point_num);
+                        for (std::size_t lookahead : {0, 8}) {
+                            auto batch_params = eval_params;
+                            batch_params.emplace_back(
+                                "lookahead", std::to_string(lookahead));
+                            runner.run("evaluate_batch", batch_params,
+                                       point_num, bytes_per_eval, [&]() {
+                                           f.evaluate(pts.begin(), pts.end(),
+                                                      vals.begin(), lookahead);
+                                           do_not_optimize(vals.back());
+                                       });
+                        }
+                        {
+                            ThreadPool pool;
+                            auto parallel_params = eval_params;
+                            parallel_params.emplace_back(
+                                "threads", std::to_string(pool.size() + 1));
+                            runner.run(
+                                "evaluate_parallel", parallel_params, point_num,
+                                bytes_per_eval, [&]() {
+                                    parallel_evaluate(f, pts.begin(), pts.end(),
+                                                      vals.begin(), pool);
+                                    do_not_optimize(vals.back());
+                                });
+                        }
+                        runner.run("derivative", eval_params, point_num,
+                                   bytes_per_eval, [&]() {
+                                       double sum{};
+                                       for (auto& x : pts) {
+                                           sum += f.derivative(x, deri_orders);
+                                       }
+                                       do_not_optimize(sum);
+                                   });
+                        runner.run("derivative_function", eval_params,
+                                   point_num, bytes_per_eval, [&]() {
+                                       double sum{};
+                                       for (auto& x : pts) { sum += f_deri(x); }
+                                       do_not_optimize(sum);
+                                   });
+                        if (pp_affordable) {
+                            const auto pp = f.pp_form();
+                            runner.run("pp_form", eval_params, point_num,
+                                       bytes_per_eval, [&]() {
+                                           double sum{};
+                                           for (auto& x : pts) {
+                                               sum += pp(x);
+                                           }
+                                           do_not_optimize(sum);
+                                       });
+                        }
+                    }
+
+                    if (D == 1 && uniform) {
+                        bench_inverse(runner, cfg, point_num);
+                    }
+                }
+            }
+        }
+    }
+    return status;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    BenchmarkRunner runner(BenchmarkRunner::parse_args(argc, argv));
+    const bool quick = runner.options().quick;
+
+    const std::vector<std::size_t> orders =
+        quick ? std::vector<std::size_t>{3}
+              : std::vector<std::size_t>{1, 2, 3, 4, 5};
+    const std::size_t point_num = quick ? 1 << 10 : 1 << 16;
+
+    std::cout << std::left << std::setw(84) << "Benchmark" << std::right
+              << std::setw(15) << "Time/item" << std::setw(15) << "Bandwidth"
+              << std::setw(10) << "Iter" << '\n';
+    std::cout << std::string(124, '-') << '\n';
+
+    int status = 0;
+    status |= bench_dim<1>(runner, orders,
+                           quick ? std::vector<std::size_t>{256}
+                                 : std::vector<std::size_t>{256, 1 << 20},
+                           point_num);
+    status |= bench_dim<2>(runner, orders,
+                           quick ? std::vector<std::size_t>{16}
+                                 : std::vector<std::size_t>{16, 1024},
+                           point_num);
+    status |= bench_dim<3>(runner, orders,
+                           quick ? std::vector<std::size_t>{8}
+                                 : std::vector<std::size_t>{8, 128},
+                           point_num);
+
+    runner.write_json({{"library_version", INTP_BENCHMARK_VERSION},
+                       {"build_type", INTP_BENCHMARK_BUILD_TYPE},
+#ifdef __VERSION__
+                       {"compiler", __VERSION__},
+#endif
+                       {"seed", std::to_string(seed)},
+                       {"quick", quick ? "true" : "false"}});
+
+    return status;
+}
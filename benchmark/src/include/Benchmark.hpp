@@ -0,0 +1,225 @@
+#ifndef INTP_BENCHMARK
+#define INTP_BENCHMARK
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Prevent compiler from optimizing away a computed value.
+ *
+ */
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile T sink;
+    sink = value;
+#endif
+}
+
+/**
+ * @brief Timing result of one benchmark case
+ *
+ */
+struct BenchmarkResult {
+    std::string family;
+    // parameters in insertion order, values are already formatted
+    std::vector<std::pair<std::string, std::string>> params;
+    std::size_t iterations;
+    std::size_t items_per_iteration;
+    double bytes_per_item;
+    // median over repetitions
+    double ns_per_item;
+
+    std::string name() const {
+        std::string n = family;
+        for (auto& p : params) { n += '/' + p.first + ':' + p.second; }
+        return n;
+    }
+
+    double gb_per_second() const { return bytes_per_item / ns_per_item; }
+};
+
+/**
+ * @brief A minimal benchmark runner in the spirit of Google Benchmark. Each
+ * case is run repeatedly until minimum time is reached, then repeated a few
+ * times and the median is reported.
+ *
+ */
+class BenchmarkRunner {
+   public:
+    struct Options {
+        double min_time = .2;  // seconds
+        std::size_t repetitions = 3;
+        std::string filter;
+        std::string json_file;
+        bool quick = false;
+    };
+
+   private:
+    Options opt_;
+    std::vector<BenchmarkResult> results_;
+
+    static std::string json_escape_(const std::string& s) {
+        std::string r;
+        for (char c : s) {
+            if (c == '"' || c == '\\') { r += '\\'; }
+            r += c;
+        }
+        return r;
+    }
+
+   public:
+    explicit BenchmarkRunner(Options opt) : opt_(std::move(opt)) {}
+
+    const Options& options() const { return opt_; }
+
+    /**
+     * @brief Parse command line arguments: --quick, --min-time=<seconds>,
+     * --repetitions=<n>, --filter=<substring>, --json=<file>
+     *
+     */
+    static Options parse_args(int argc, char** argv) {
+        Options opt;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg(argv[i]);
+            const auto value = [&](const std::string& key) {
+                return arg.substr(key.size());
+            };
+            if (arg == "--quick") {
+                opt.quick = true;
+                opt.min_time = .005;
+                opt.repetitions = 1;
+            } else if (arg.rfind("--min-time=", 0) == 0) {
+                opt.min_time = std::stod(value("--min-time="));
+            } else if (arg.rfind("--repetitions=", 0) == 0) {
+                opt.repetitions = std::stoul(value("--repetitions="));
+            } else if (arg.rfind("--filter=", 0) == 0) {
+                opt.filter = value("--filter=");
+            } else if (arg.rfind("--json=", 0) == 0) {
+                opt.json_file = value("--json=");
+            } else {
+                std::cerr << "Unknown argument: " << arg << '\n';
+            }
+        }
+        return opt;
+    }
+
+    /**
+     * @brief Time a benchmark case.
+     *
+     * @param family benchmark family name, e.g. "evaluate"
+     * @param params parameters of this case
+     * @param items_per_iteration number of items (evaluations, grid points,
+     * ...) processed by one call of body
+     * @param bytes_per_item memory traffic per item, for bandwidth estimation
+     * @param body the code to be timed
+     */
+    template <typename Func>
+    void run(std::string family,
+             std::vector<std::pair<std::string, std::string>> params,
+             std::size_t items_per_iteration,
+             double bytes_per_item,
+             Func&& body) {
+        BenchmarkResult result{std::move(family), std::move(params), 0,
+                               items_per_iteration, bytes_per_item, 0};
+        const std::string name = result.name();
+        if (!opt_.filter.empty() &&
+            name.find(opt_.filter) == std::string::npos) {
+            return;
+        }
+
+        using clock = std::chrono::steady_clock;
+        // warm up, and estimate iterations needed to reach minimum time
+        auto t0 = clock::now();
+        body();
+        double elapsed =
+            std::chrono::duration<double>(clock::now() - t0).count();
+        const std::size_t iterations =
+            elapsed >= opt_.min_time
+                ? 1
+                : static_cast<std::size_t>(opt_.min_time /
+                                           std::max(elapsed, 1e-9)) +
+                      1;
+
+        std::vector<double> samples;
+        for (std::size_t r = 0; r < opt_.repetitions; ++r) {
+            t0 = clock::now();
+            for (std::size_t i = 0; i < iterations; ++i) { body(); }
+            elapsed = std::chrono::duration<double, std::nano>(clock::now() -
+                                                               t0)
+                          .count();
+            samples.push_back(elapsed / static_cast<double>(
+                                            iterations * items_per_iteration));
+        }
+        std::nth_element(samples.begin(),
+                         samples.begin() + static_cast<std::ptrdiff_t>(
+                                               samples.size() / 2),
+                         samples.end());
+        result.iterations = iterations;
+        result.ns_per_item = samples[samples.size() / 2];
+
+        std::cout << std::left << std::setw(84) << name << std::right
+                  << std::setw(12) << std::fixed << std::setprecision(2)
+                  << result.ns_per_item << " ns" << std::setw(10)
+                  << result.gb_per_second() << " GB/s" << std::setw(10)
+                  << iterations << '\n';
+        results_.push_back(std::move(result));
+    }
+
+    /**
+     * @brief Write results in JSON, to the file given in options.
+     *
+     * @param context key-value pairs describing the run environment
+     */
+    void write_json(
+        const std::vector<std::pair<std::string, std::string>>& context) const {
+        if (opt_.json_file.empty()) { return; }
+        std::ofstream out(opt_.json_file);
+        out << "{\n  \"context\": {\n";
+        char date[32];
+        const std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S",
+                      std::localtime(&now));
+        out << "    \"date\": \"" << date << "\",\n";
+        out << "    \"min_time\": " << opt_.min_time << ",\n";
+        out << "    \"repetitions\": " << opt_.repetitions;
+        for (auto& c : context) {
+            out << ",\n    \"" << json_escape_(c.first) << "\": \""
+                << json_escape_(c.second) << '"';
+        }
+        out << "\n  },\n  \"benchmarks\": [";
+        out.precision(6);
+        for (std::size_t i = 0; i < results_.size(); ++i) {
+            const auto& r = results_[i];
+            out << (i == 0 ? "\n" : ",\n") << "    {\n";
+            out << "      \"name\": \"" << json_escape_(r.name()) << "\",\n";
+            out << "      \"family\": \"" << json_escape_(r.family) << "\",\n";
+            for (auto& p : r.params) {
+                out << "      \"" << json_escape_(p.first) << "\": \""
+                    << json_escape_(p.second) << "\",\n";
+            }
+            out << "      \"iterations\": " << r.iterations << ",\n";
+            out << "      \"items_per_iteration\": " << r.items_per_iteration
+                << ",\n";
+            out << "      \"ns_per_item\": " << r.ns_per_item << ",\n";
+            out << "      \"bytes_per_item\": " << r.bytes_per_item << ",\n";
+            out << "      \"gb_per_second\": " << r.gb_per_second() << "\n";
+            out << "    }";
+        }
+        out << "\n  ]\n}\n";
+        std::cout << "\nResults written to " << opt_.json_file << '\n';
+    }
+};
+
+#endif
@@ -85,3 +85,11 @@ result3d = bspline(order,isperiodic,range,f3d,coor3d2,derivative);
 
 result3d_mma = [-0.20015704400375117,0.5183267778903129,-0.7197026899005371,0.5183443130595233,-0.07245353025037997,0.5534353986280456,-0.2674229002109916,0.1673843822053797,-0.021928200124974297,-0.260677062462001]';
 abs_error = mean(abs(result3d_mma-result3d))
+
+%% 3D handle, fit once and evaluate many times
+
+h = bspline('fit',order,isperiodic,range,f3d);
+result3d = bspline('eval',h,coor3d2);
+abs_error = mean(abs(result3d_mma-result3d))
+result3d_dx = bspline('eval',h,coor3d2,uint64([1,0,0])');
+bspline('free',h);
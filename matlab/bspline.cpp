@@ -1,182 +1,266 @@
 /* This is a C++ MEX file for MATLAB.
 C++ B-spline interpolation interface
 https://github.com/12ff54e/BSplineInterpolation
+
+Usage:
+    result = bspline(order, is_periodic, range, mesh, coor, derivative)
+        fit and evaluate in one call
+    h = bspline('fit', order, is_periodic, range, mesh)
+        fit and keep the function alive between calls, returning a handle
+    result = bspline('eval', h, coor[, derivative])
+        evaluate a kept function, derivative orders defaulted to zeros
+    bspline('free'[, h])
+        release a kept function, or all of them if h is omitted
+
+Kept functions are released by `clear bspline` as well.
 */
 
-#include <iostream>
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 #include <Interpolation.hpp>
+#include <ThreadPool.hpp>
 #include "mex.hpp"
 #include "mexAdapter.hpp"
 
-template<typename T> struct make_inverse_index_sequence_impl;
-template<std::size_t... Is> struct make_inverse_index_sequence_impl<std::index_sequence<Is...>>
-{
-    using type = std::index_sequence<sizeof...(Is) - Is - 1 ...>;
-};
-template<std::size_t N> using make_inverse_index_sequence = typename make_inverse_index_sequence_impl<std::make_index_sequence<N>>::type;
-
 using namespace matlab::engine;
-using namespace  matlab::data;
+using namespace matlab::data;
+
+// query points evaluated in one chunk at least
+constexpr std::size_t min_points_per_chunk = 1024;
 
-decltype(auto) get_matlab_arr(auto&& x, auto i, auto... is)
+// Dimensions of a MATLAB array are reversed in the corresponding Mesh, so that
+// the column-major MATLAB buffer and the row-major Mesh share the same layout.
+class FittedFunction
 {
-    if constexpr (sizeof...(is) == 0)
-        return x[i];
-    else
-        return get_matlab_arr(x[i], is...);
-}
-
-template<std::size_t I = 0, typename F, std::size_t N>
-void range_invoke_row_major(F&& f, const std::array<std::size_t, N>& range, auto... is)
+public:
+    virtual ~FittedFunction() = default;
+    virtual std::size_t dim() const = 0;
+    virtual std::vector<double> evaluate(const TypedArray<double>& coor_in, const std::vector<std::size_t>& derivative, intp::ThreadPool& pool) const = 0;
+};
+
+template<std::size_t Dim>
+class FittedFunctionND : public FittedFunction
 {
-    if constexpr (I == N)
-        f(is...);
-    else
+    using function_type = intp::InterpolationFunction<double, Dim>;
+
+    // shared by all worker threads
+    function_type function_;
+
+    static intp::Mesh<double, Dim> map_mesh(const TypedArray<bool>& is_periodic, const TypedArray<double>& mesh_in)
     {
-        for (std::size_t i = 0; i < range[I]; i++)
-            range_invoke_row_major<I + 1>(std::forward<F>(f), range, is..., i);
+        const auto matlab_dims = mesh_in.getDimensions();
+        // the last point of periodic dimension is not passed from MATLAB,
+        // and it is ignored in fitting
+        typename intp::Mesh<double, Dim>::index_type sizes;
+        for (std::size_t d = 0; d < Dim; d++)
+            sizes[Dim - 1 - d] = matlab_dims[d] + std::size_t{ is_periodic[d] };
+        intp::MeshDimension<Dim> mesh_dim;
+        mesh_dim.resize(sizes);
+        intp::Mesh<double, Dim> f_nd{ mesh_dim };
+
+        // copy contiguous runs along the first MATLAB dimension
+        const std::size_t run = matlab_dims[0];
+        const std::size_t run_num = mesh_in.getNumberOfElements() / run;
+        auto src = mesh_in.cbegin();
+        for (std::size_t r = 0; r < run_num; r++)
+        {
+            typename intp::Mesh<double, Dim>::index_type idx{};
+            for (std::size_t d = 1, rest = r; d < Dim; d++)
+            {
+                idx[Dim - 1 - d] = rest % matlab_dims[d];
+                rest /= matlab_dims[d];
+            }
+            std::copy(src, src + static_cast<std::ptrdiff_t>(run), f_nd.data() + mesh_dim.indexing(idx));
+            src += static_cast<std::ptrdiff_t>(run);
+        }
+        return f_nd;
     }
-}
 
-template<std::size_t I = 0, typename F, std::size_t N>
-void range_invoke_col_major(F&& f, const std::array<std::size_t, N>& range, auto... is)
-{
-    if constexpr (I == N)
-        f(is...);
-    else
+    template<std::size_t... Is>
+    static function_type fit(std::uint64_t order, const TypedArray<bool>& is_periodic, const TypedArray<double>& range, const intp::Mesh<double, Dim>& f_nd, std::index_sequence<Is...>)
     {
-        //std::cout << "range " << I << " dim " << range[N - 1 - I] << std::endl;
-        for (std::size_t i = 0; i < range[N - 1 - I]; i++)
-            range_invoke_col_major<I + 1>(std::forward<F>(f), range, i, is...);
+        return function_type{ order, { is_periodic[Dim - 1 - Is]... }, f_nd,
+            std::make_pair(double{ range[Dim - 1 - Is][0] }, double{ range[Dim - 1 - Is][1] })... };
     }
-}
 
-decltype(auto) reverse_invoke(auto&& f, auto&&... is)
-{
-    const auto tup = std::tuple{ is... };
-    return [&] <std::size_t... Is>(std::index_sequence<Is...>)->decltype(auto) {
-        return f(std::get<Is>(tup)...);
-    }(make_inverse_index_sequence<sizeof...(is)>{});
-}
+public:
+    FittedFunctionND(std::uint64_t order, const TypedArray<bool>& is_periodic, const TypedArray<double>& range, const TypedArray<double>& mesh_in)
+        : function_(fit(order, is_periodic, range, map_mesh(is_periodic, mesh_in), std::make_index_sequence<Dim>{}))
+    {
+    }
+
+    std::size_t dim() const override { return Dim; }
+
+    std::vector<double> evaluate(const TypedArray<double>& coor_in, const std::vector<std::size_t>& derivative, intp::ThreadPool& pool) const override
+    {
+        // N x Dim column-major coordinates, each column copied contiguously
+        const std::size_t n = coor_in.getDimensions()[0];
+        std::vector<std::array<double, Dim>> points(n);
+        auto src = coor_in.cbegin();
+        for (std::size_t d = 0; d < Dim; d++)
+            for (std::size_t i = 0; i < n; i++, ++src)
+                points[i][Dim - 1 - d] = *src;
+
+        std::array<std::size_t, Dim> orders{};
+        bool has_derivative = false;
+        for (std::size_t d = 0; d < Dim; d++)
+        {
+            orders[Dim - 1 - d] = derivative.empty() ? 0 : derivative[d];
+            has_derivative = has_derivative || orders[Dim - 1 - d] != 0;
+        }
+
+        std::vector<double> result(n);
+        if (!has_derivative)
+        {
+            intp::parallel_evaluate(function_, points.begin(), points.end(), result.begin(), pool, min_points_per_chunk);
+            return result;
+        }
+        intp::parallel_for(n, [&](std::size_t lo, std::size_t hi) {
+            for (std::size_t i = lo; i < hi; i++)
+                result[i] = function_.derivative(points[i], orders);
+        }, pool, min_points_per_chunk);
+        return result;
+    }
+};
 
 class MexFunction : public matlab::mex::Function {
 
     ArrayFactory factory;
     std::shared_ptr<MATLABEngine> matlabPtr = getEngine();
 
-public:
-    template<std::size_t Dim>
-    void interpolation_nd(const uint64_t order, const TypedArray<bool>& is_periodic, const TypedArray<double>& range, const TypedArray<double>& mesh_in, const TypedArray<double>& coor_in, const TypedArray<std::size_t>& derivative_in, TypedArray<double>& result)
+    // functions kept alive between calls, released by `clear bspline`
+    std::unordered_map<std::uint64_t, std::unique_ptr<FittedFunction>> functions;
+    std::uint64_t next_handle = 1;
+
+    // workers evaluating kept functions, together with the MATLAB thread
+    intp::ThreadPool pool{ std::max(1u, std::thread::hardware_concurrency()) - 1 };
+
+    void error(const std::string& msg)
     {
-       
-        // dim
-        const std::array<std::size_t, Dim> Dims = [&]<std::size_t... Is>(auto & grid, std::index_sequence<Is...>) {
-            return std::array<std::size_t, Dim>{grid.getDimensions()[Is]...};
-        }(mesh_in, std::make_index_sequence<Dim>{});
-
-        // mesh
-        auto f_nd = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
-            //((std::cout << "Mesh size = " << Dims[Is] + std::size_t{ is_periodic[Is] } << std::endl), ...);
-            return  intp::Mesh<double, Dim>{ Dims[Is] + std::size_t{ is_periodic[Is] }... };
-        }(make_inverse_index_sequence<Dim>{});
-
-        range_invoke_col_major([&](auto... is)
-            {
-                reverse_invoke(f_nd, is...) = get_matlab_arr(mesh_in, is...);
-            }, Dims);
-      
-        // interpolation initial
-        auto interpolation_function = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
-            return  intp::InterpolationFunction<double, Dim>{
-                order, { is_periodic[Is]... }, f_nd,
-                    std::make_pair(double{ range[Is][0] }, double{ range[Is][1] })...};
-        }(make_inverse_index_sequence<Dim>{});
-
-        // interpolation
-        for (std::size_t i = 0; i < coor_in.getDimensions()[0]; i++)
-        {
-            result[i] = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
-                //return  interpolation_function(double{ coor_in[i][Is] }...);
-                return  interpolation_function.derivative({ double{ coor_in[i][Is] }... },{ derivative_in[Is]...});
-            }(make_inverse_index_sequence<Dim>{});
-        }
+        matlabPtr->feval(u"error", 0, std::vector<Array>({ factory.createScalar(msg) }));
     }
 
-    void operator()(matlab::mex::ArgumentList outputs, matlab::mex::ArgumentList inputs) override {
-        // inputs : ( order, is periodic, range, array, array interpolation, derivative )
-        // outputs : ( result )
-        checkArguments(outputs, inputs);
-
-        const uint64_t order = inputs[0][0];
-        const TypedArray<bool> is_periodic = std::move(inputs[1]);
-        const TypedArray<double> range = std::move(inputs[2]);
-        const TypedArray<double> mesh_in = std::move(inputs[3]);
-        const TypedArray<double> coor_in = std::move(inputs[4]);
-        const TypedArray<std::size_t> derivative_in = std::move(inputs[5]);
-        TypedArray<double> result = factory.createArray<double>({ coor_in.getDimensions()[0] });
-
+    static std::size_t mesh_dim(const TypedArray<double>& mesh_in)
+    {
         std::size_t dim = 0;
         for (std::size_t i = 0; i < mesh_in.getDimensions().size(); i++)
             if (mesh_in.getDimensions()[i] > 1) dim++;
+        return dim;
+    }
+
+    // inputs : ( order, is periodic, range, array )
+    std::unique_ptr<FittedFunction> fit(const Array& order_in, const Array& periodic_in, const Array& range_in, const Array& mesh_arr)
+    {
+        if (order_in.getType() != ArrayType::UINT64 || periodic_in.getType() != ArrayType::LOGICAL || range_in.getType() != ArrayType::DOUBLE || mesh_arr.getType() != ArrayType::DOUBLE)
+            error("Input type error");
+        const std::uint64_t order = TypedArray<std::uint64_t>(order_in)[0];
+        const TypedArray<bool> is_periodic = periodic_in;
+        const TypedArray<double> range = range_in;
+        const TypedArray<double> mesh_in = mesh_arr;
+        const std::size_t dim = mesh_dim(mesh_in);
+
+        if (range.getDimensions().size() != 2 || range.getDimensions()[0] != dim || range.getDimensions()[1] != 2)
+            error("Range require Dim * 2 array");
+        if (mesh_in.getDimensions()[0] == 1)
+            error("Mesh should be col vector for 1 dimension");
+        if (is_periodic.getDimensions()[0] != dim)
+            error("is_periodic require length dim array");
 
-        //switch (const auto dim = mesh_in.getDimensions().size())
         switch (dim)
         {
         case 1:
-            interpolation_nd<1>(order, is_periodic, range, mesh_in, coor_in, derivative_in, result);
-            break;
+            return std::make_unique<FittedFunctionND<1>>(order, is_periodic, range, mesh_in);
         case 2:
-            interpolation_nd<2>(order, is_periodic, range, mesh_in, coor_in, derivative_in, result);
-            break;
+            return std::make_unique<FittedFunctionND<2>>(order, is_periodic, range, mesh_in);
         case 3:
-            interpolation_nd<3>(order, is_periodic, range, mesh_in, coor_in, derivative_in, result);
-            break;
+            return std::make_unique<FittedFunctionND<3>>(order, is_periodic, range, mesh_in);
         default:
-            std::cout << "unsupport dim, you need add dim " << dim << " in bspline.cpp." << std::endl;
-            throw;
+            error("unsupport dim, you need add dim " + std::to_string(dim) + " in bspline.cpp.");
+            return nullptr;
         }
-        TypedArray<double> outputArray = factory.createArray({ result.getDimensions()[0] }, result.cbegin(), result.cend());
-		outputs[0] = std::move(outputArray);
     }
 
-    void checkArguments(matlab::mex::ArgumentList& outputs, matlab::mex::ArgumentList& inputs) {
-        if (inputs.size() != 6) {
-            matlabPtr->feval(u"error", 0,
-                std::vector<Array>({ factory.createScalar("Six input required") }));
-        }
-        if(inputs[0].getType()!=ArrayType::UINT64 || inputs[1].getType()!=ArrayType::LOGICAL || inputs[2].getType()!=ArrayType::DOUBLE || inputs[3].getType() != ArrayType::DOUBLE || inputs[4].getType() != ArrayType::DOUBLE || inputs[5].getType() != ArrayType::UINT64) {
-            matlabPtr->feval(u"error", 0,
-                std::vector<Array>({ factory.createScalar("Input type error") }));
+    // inputs : ( array interpolation[, derivative] )
+    Array evaluate(const FittedFunction& f, const Array& coor_arr, const Array* derivative_arr)
+    {
+        if (coor_arr.getType() != ArrayType::DOUBLE || (derivative_arr && derivative_arr->getType() != ArrayType::UINT64))
+            error("Input type error");
+        const TypedArray<double> coor_in = coor_arr;
+        if (coor_in.getDimensions().size() != 2 || coor_in.getDimensions()[1] != f.dim())
+            error("Interpolate coordinate require N * dim array");
+
+        std::vector<std::size_t> derivative;
+        if (derivative_arr)
+        {
+            const TypedArray<std::uint64_t> derivative_in = *derivative_arr;
+            if (derivative_in.getNumberOfElements() != f.dim())
+                error("derivative_in require length dim array");
+            derivative.assign(derivative_in.cbegin(), derivative_in.cend());
         }
-        const uint64_t order = inputs[0][0];
-        const TypedArray<bool> is_periodic = inputs[1];
-        const TypedArray<double> range = inputs[2];
-        const TypedArray<double> mesh_in = inputs[3];
-        const TypedArray<double> coor_in = inputs[4];
-        const TypedArray<std::size_t> derivative_in = inputs[5];
-        std::size_t dim = 0;
-        for (std::size_t i = 0; i < mesh_in.getDimensions().size(); i++)
-            if (mesh_in.getDimensions()[i] > 1) dim++;
 
-        if (range.getDimensions().size() != 2 || range.getDimensions()[0]!=dim || range.getDimensions()[1] != 2) {
-            matlabPtr->feval(u"error", 0,
-                std::vector<Array>({ factory.createScalar("Range require Dim * 2 array") }));
+        const auto result = f.evaluate(coor_in, derivative, pool);
+        return factory.createArray({ result.size(), 1 }, result.cbegin(), result.cend());
+    }
+
+    const FittedFunction& find(const Array& handle_in)
+    {
+        if (handle_in.getType() != ArrayType::UINT64)
+            error("Handle should be uint64");
+        const auto it = functions.find(TypedArray<std::uint64_t>(handle_in)[0]);
+        if (it == functions.end())
+            error("Invalid or released handle");
+        return *it->second;
+    }
+
+public:
+    void operator()(matlab::mex::ArgumentList outputs, matlab::mex::ArgumentList inputs) override {
+        if (inputs.size() == 0)
+            error("Input required");
+
+        if (inputs[0].getType() != ArrayType::CHAR)
+        {
+            // legacy form, fit and evaluate in one call
+            // inputs : ( order, is periodic, range, array, array interpolation, derivative )
+            // outputs : ( result )
+            if (inputs.size() != 6)
+                error("Six input required");
+            const auto f = fit(inputs[0], inputs[1], inputs[2], inputs[3]);
+            outputs[0] = evaluate(*f, inputs[4], &inputs[5]);
+            return;
         }
-        if(mesh_in.getDimensions()[0]==1)
+
+        const std::string command = CharArray(inputs[0]).toAscii();
+        if (command == "fit")
         {
-            matlabPtr->feval(u"error", 0,
-                std::vector<Array>({ factory.createScalar("Mesh should be col vector for 1 dimension") }));
+            if (inputs.size() != 5)
+                error("fit requires order, is_periodic, range and mesh");
+            const std::uint64_t handle = next_handle++;
+            functions.emplace(handle, fit(inputs[1], inputs[2], inputs[3], inputs[4]));
+            outputs[0] = factory.createScalar<std::uint64_t>(handle);
         }
-        if(is_periodic.getDimensions()[0]!= dim || derivative_in.getDimensions()[0] != dim)
+        else if (command == "eval")
         {
-            matlabPtr->feval(u"error", 0,
-                std::vector<Array>({ factory.createScalar("is_periodic, derivative_in require length dim array") }));
+            if (inputs.size() != 3 && inputs.size() != 4)
+                error("eval requires handle, coordinates and optionally derivative");
+            outputs[0] = evaluate(find(inputs[1]), inputs[2], inputs.size() == 4 ? &inputs[3] : nullptr);
         }
-        if (coor_in.getDimensions().size() != 2 || coor_in.getDimensions()[1] != dim)
+        else if (command == "free")
         {
-            matlabPtr->feval(u"error", 0,
-                std::vector<Array>({ factory.createScalar("Interpolate coordinate require N * dim array") }));
+            if (inputs.size() == 1)
+                functions.clear();
+            else
+            {
+                find(inputs[1]);
+                functions.erase(TypedArray<std::uint64_t>(inputs[1])[0]);
+            }
         }
+        else
+            error("Unknown command " + command);
     }
 };
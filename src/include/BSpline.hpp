@@ -6,26 +6,35 @@
 #include <cmath>        // fmod
 #include <functional>   // ref
 #include <iterator>     // distance
+#include <limits>       // numeric_limits
 #include <stdexcept>    // range_error
 #include <type_traits>  // is_same, is_arithmatic
+#include <utility>      // declval
 #include <vector>
 
 #ifdef _DEBUG
 #include <iostream>
 #endif
 
+#include "Instrumentation.hpp"
 #include "Mesh.hpp"
 #include "util.hpp"
 
 namespace intp {
 
+template <typename T, size_t D>
+class PiecewisePolynomial;
+
 /**
  * @brief B-Spline function
  *
  * @tparam T Type of control point
  * @tparam D Dimension
+ * @tparam Container Control point container, defaulted to Mesh<T, D>. Other
+ * containers (e.g. ChunkedMesh) should at least provide `dim_size(dim_ind)`
+ * and element access by index array, which suffice for evaluation.
  */
-template <typename T, size_t D>
+template <typename T, size_t D, typename Container = Mesh<T, D>>
 class BSpline {
    public:
     using size_type = size_t;
@@ -33,12 +42,13 @@ class BSpline {
     using knot_type = double;
 
     using KnotContainer = std::vector<knot_type>;
-    using ControlPointContainer = Mesh<val_type, D>;
+    using ControlPointContainer = Container;
 
     using BaseSpline = std::vector<knot_type>;
     using diff_type = KnotContainer::iterator::difference_type;
 
     const static size_type dim = D;
+    // maximum spline order among all dimensions
     const size_type order;
 
     // Container for dimension-wise storage
@@ -55,15 +65,16 @@ class BSpline {
      * @param x coordinate
      * @param spline_order order of base spline, defaulted to be spline function
      * order
-     * @return a reference to local buffer
+     * @return a reference to local buffer of the calling thread
      */
     inline const BaseSpline& base_spline_value(
         size_type,
         KnotContainer::const_iterator seg_idx_iter,
         knot_type x,
         size_type spline_order) const {
-        std::fill(base_spline_buf_.begin(), base_spline_buf_.end(), 0);
-        base_spline_buf_[order] = 1;
+        BaseSpline& base_spline_buf = base_spline_buf_();
+        base_spline_buf.assign(order + 1, 0);
+        base_spline_buf[order] = 1;
 
         for (size_type i = 1; i <= spline_order; ++i) {
             // Each iteration will expand buffer zone by one, from back
@@ -74,36 +85,37 @@ class BSpline {
                     seg_idx_iter - static_cast<diff_type>(i - j);
                 const auto right_iter =
                     seg_idx_iter + static_cast<diff_type>(j + 1);
-                base_spline_buf_[idx_begin + j] =
+                base_spline_buf[idx_begin + j] =
                     (j == 0
                          ? 0
-                         : base_spline_buf_[idx_begin + j] * (x - *left_iter) /
+                         : base_spline_buf[idx_begin + j] * (x - *left_iter) /
                                (*(right_iter - 1) - *left_iter)) +
                     (idx_begin + j == order
                          ? 0
-                         : base_spline_buf_[idx_begin + j + 1] *
+                         : base_spline_buf[idx_begin + j + 1] *
                                (*right_iter - x) /
                                (*right_iter - *(left_iter + 1)));
             }
         }
         // }
-        return base_spline_buf_;
+        return base_spline_buf;
     }
 
     inline const BaseSpline& base_spline_value(
         size_type dim_ind,
         KnotContainer::const_iterator seg_idx_iter,
         knot_type x) const {
-        return base_spline_value(dim_ind, seg_idx_iter, x, order);
+        return base_spline_value(dim_ind, seg_idx_iter, x, orders_[dim_ind]);
     }
 
     /**
-     * @brief Return the result of last call for this method
+     * @brief Return the result of last call for this method in the calling
+     * thread
      *
-     * @return a reference to local buffer
+     * @return a reference to local buffer of the calling thread
      */
     inline const std::vector<knot_type>& base_spline_value() const {
-        return base_spline_buf_;
+        return base_spline_buf_();
     }
 
     /**
@@ -137,6 +149,20 @@ class BSpline {
             std::cout << "[DEBUG] knot hint miss at dim = " << dim_ind
                       << ", hint = " << hint << ", x = " << x << '\n';
         }
+#endif
+#ifdef INTP_ENABLE_INSTRUMENTATION
+        if (!periodicity_[dim_ind] &&
+            (x < range(dim_ind).first || x > range(dim_ind).second)) {
+            INTP_COUNT(out_of_range);
+        }
+        if (*iter <= x && *(iter + 1) > x) {
+            INTP_COUNT(knot_hint_hit);
+        } else {
+            INTP_COUNT(knot_hint_miss);
+            INTP_COUNT_ADD(binary_search_steps,
+                           instrument::bisection_steps(
+                               last + 1 - (orders_[dim_ind] + 1)));
+        }
 #endif
         // I tried return the iter without checking, but the speed has no
         // significant improves.
@@ -147,7 +173,8 @@ class BSpline {
                    // (excluding beginning and ending knots that have same
                    // value)
                    : --(std::upper_bound(knots_begin(dim_ind) +
-                                             static_cast<diff_type>(order + 1),
+                                             static_cast<diff_type>(
+                                                 orders_[dim_ind] + 1),
                                          knots_begin(dim_ind) +
                                              static_cast<diff_type>(last + 1),
                                          x));
@@ -156,7 +183,8 @@ class BSpline {
     inline KnotContainer::const_iterator get_knot_iter(size_type dim_ind,
                                                        knot_type& x,
                                                        size_type hint) const {
-        return get_knot_iter(dim_ind, x, hint, knots_num(dim_ind) - order - 2);
+        return get_knot_iter(dim_ind, x, hint,
+                             knots_num(dim_ind) - orders_[dim_ind] - 2);
     }
 
     template <typename... CoordWithHints, size_type... indices>
@@ -169,11 +197,11 @@ class BSpline {
    private:
     DimArray<bool> periodicity_;
     DimArray<bool> uniform_;
+    DimArray<size_type> orders_;
 
     DimArray<KnotContainer> knots_;
     ControlPointContainer control_points_;
 
-    mutable BaseSpline base_spline_buf_;
     DimArray<std::pair<knot_type, knot_type>> range_;
 
     const size_type buf_size_;
@@ -183,8 +211,133 @@ class BSpline {
     // value.
     constexpr static size_type MAX_BUF_SIZE_ = 1000;
 
+    template <typename, size_t>
+    friend class PiecewisePolynomial;
+    // for updating control points in place
+    template <typename, size_t>
+    friend class InterpolationFunctionTemplate;
+    // for collecting control points of functions sharing knots
+    template <typename, size_t>
+    friend class SplineCollection;
+
     // auxiliary methods
 
+    /**
+     * @brief Buffer of base spline values. It is owned by each thread rather
+     * than each spline, so that one spline can be evaluated concurrently.
+     *
+     */
+    static BaseSpline& base_spline_buf_() {
+        thread_local BaseSpline buf;
+        return buf;
+    }
+
+    /**
+     * @brief Index of the first control point involved in evaluation in each
+     * dimension, given knot iters found by `get_knot_iters`. When the
+     * coordinate is out of range in some dimensions, the corresponding
+     * iterator was set to be begin or end iterator of knot vector and it is
+     * treated separately.
+     *
+     */
+    DimArray<size_type> stencil_begin_(
+        const DimArray<KnotContainer::const_iterator>& knot_iters) const {
+        DimArray<size_type> begin;
+        for (size_type d = 0; d < dim; ++d) {
+            begin[d] = knot_iters[d] == knots_begin(d) ? 0
+                       : knot_iters[d] == knots_end(d)
+                           ? control_points_.dim_size(d) - orders_[d] - 1
+                           : static_cast<size_type>(distance(knots_begin(d),
+                                                             knot_iters[d])) -
+                                 orders_[d];
+        }
+        return begin;
+    }
+
+    /**
+     * @brief Spline value at coordinates whose knot iters are already found.
+     *
+     */
+    template <size_type... indices>
+    val_type value_at_(
+        util::index_sequence<indices...>,
+        const DimArray<KnotContainer::const_iterator>& knot_iters,
+        const DimArray<knot_type>& coord) const {
+        INTP_COUNT(evaluations);
+        // calculate basic spline (out of boundary check also conducted here)
+        const auto base_spline_values_1d = calc_base_spline_vals(
+            util::index_sequence<indices...>{}, knot_iters, orders_,
+            coord[indices]...);
+        const auto stencil_begin = stencil_begin_(knot_iters);
+
+        // combine control points and basic spline values to get spline value
+        val_type v{};
+        for (size_type i = 0; i < buf_size_; ++i) {
+            DimArray<size_type> ind_arr;
+            for (size_type d = 0, combined_ind = i; d < dim; ++d) {
+                ind_arr[d] = combined_ind % (orders_[d] + 1);
+                combined_ind /= (orders_[d] + 1);
+            }
+
+            val_type coef = 1;
+            for (size_type d = 0; d < dim; ++d) {
+                // base spline values are aligned at right
+                coef *=
+                    base_spline_values_1d[d][order - orders_[d] + ind_arr[d]];
+
+                // Shift index array according to knot iter of each dimension.
+                ind_arr[d] += stencil_begin[d];
+
+                // check periodicity, put out-of-right-boundary index to left
+                if (periodicity_[d]) {
+                    ind_arr[d] %= control_points_.dim_size(d);
+                }
+            }
+
+            v += coef * control_points_(ind_arr);
+        }
+
+        return v;
+    }
+
+    /**
+     * @brief Prefetch control points involved in evaluation, one request per
+     * row along the last dimension. This overload is chosen if the control
+     * point container supports prefetching.
+     *
+     */
+    template <typename C = ControlPointContainer>
+    auto prefetch_stencil_(const DimArray<size_type>& stencil_begin, int) const
+        -> decltype(std::declval<const C&>().prefetch(stencil_begin)) {
+        const size_type row_num = buf_size_ / (orders_[dim - 1] + 1);
+        for (size_type r = 0; r < row_num; ++r) {
+            DimArray<size_type> ind_arr;
+            for (size_type d = 0, combined_ind = r; d < dim - 1; ++d) {
+                ind_arr[d] =
+                    stencil_begin[d] + combined_ind % (orders_[d] + 1);
+                combined_ind /= (orders_[d] + 1);
+                if (periodicity_[d]) {
+                    ind_arr[d] %= control_points_.dim_size(d);
+                }
+            }
+            ind_arr[dim - 1] = stencil_begin[dim - 1];
+            control_points_.prefetch(ind_arr);
+        }
+    }
+
+    void prefetch_stencil_(const DimArray<size_type>&, long) const {}
+
+    /**
+     * @brief Get number of control points involved in evaluating spline value
+     * at one point, given spline order of each dimension.
+     *
+     */
+    static size_type local_size_(const DimArray<size_type>& spline_orders) {
+        size_type s = 1;
+        for (auto o : spline_orders) { s *= o + 1; }
+        return s;
+    }
+
     /**
      * @brief Calculate base spline value of each dimension
      *
@@ -195,7 +348,7 @@ class BSpline {
      * @param coords a bunch of coordinates
      */
     template <typename... Coords, size_type... indices>
-    inline DimArray<decltype(base_spline_buf_)> calc_base_spline_vals(
+    inline DimArray<BaseSpline> calc_base_spline_vals(
         util::index_sequence<indices...>,
         const DimArray<KnotContainer::const_iterator>& knot_iters,
         const DimArray<size_type>& spline_order,
@@ -204,6 +357,612 @@ class BSpline {
                                   spline_order[indices])...};
     }
 
+    /**
+     * @brief Accumulate primitive functions of base splines of one dimension,
+     * i.e. integrals of each base spline from the beginning of knot vector to
+     * x, onto the control point index it multiplies. It makes use of the
+     * closed form expression
+     * $\int_{-\infty}^x B_{i,k} = \frac{t_{i+k+1}-t_i}{k+1}\sum_{j\geq
+     * i}B_{j,k+1}(x)$.
+     *
+     * @param dim_ind dimension index
+     * @param x coordinate, not wrapped even in periodic dimension
+     * @param factor a factor multiplied to the primitive values
+     * @param weights accumulation destination, indexed by control point
+     */
+    void accumulate_base_spline_primitive_(
+        size_type dim_ind,
+        knot_type x,
+        knot_type factor,
+        std::vector<knot_type>& weights) const {
+        const size_type k = orders_[dim_ind];
+        const auto knots = knots_begin(dim_ind);
+        const size_type ctrl_num = control_points_.dim_size(dim_ind);
+        // segment index, searched in the same way as `get_knot_iter`
+        const size_type seg = static_cast<size_type>(
+            std::upper_bound(
+                knots + static_cast<diff_type>(k + 1),
+                knots + static_cast<diff_type>(knots_num(dim_ind) - k - 1),
+                x) -
+            knots - 1);
+        const auto support_len = [&](size_type i) {
+            return (knots[static_cast<diff_type>(i + k + 1)] -
+                    knots[static_cast<diff_type>(i)]) /
+                   static_cast<knot_type>(k + 1);
+        };
+
+        // base splines to the left of the segment are fully integrated
+        for (size_type i = 0; i < seg - k; ++i) {
+            weights[i % ctrl_num] += factor * support_len(i);
+        }
+
+        // base splines of k+1 on the segment, by Cox-de Boor recursion
+        std::vector<knot_type> raised(k + 2, 0);
+        std::vector<knot_type> left(k + 2), right(k + 2);
+        raised[0] = 1;
+        for (size_type p = 1; p <= k + 1; ++p) {
+            left[p] = x - knots[static_cast<diff_type>(seg + 1 - p)];
+            right[p] = knots[static_cast<diff_type>(seg + p)] - x;
+            knot_type saved{};
+            for (size_type r = 0; r < p; ++r) {
+                const knot_type tmp = raised[r] / (right[r + 1] + left[p - r]);
+                raised[r] = saved + right[r + 1] * tmp;
+                saved = left[p - r] * tmp;
+            }
+            raised[p] = saved;
+        }
+
+        // base splines covering the segment are partially integrated
+        knot_type suffix_sum{};
+        for (size_type j = k + 1; j > 0; --j) {
+            suffix_sum += raised[j];
+            const size_type i = seg - k - 1 + j;
+            weights[i % ctrl_num] += factor * support_len(i) * suffix_sum;
+        }
+    }
+
+    /**
+     * @brief Contract control points along one dimension with given weights,
+     * yielding a spline of one dimension lower.
+     *
+     * @param dim_ind dimension index
+     * @param weights weights of each control point along that dimension
+     */
+    template <size_type D_ = dim>
+    typename std::enable_if<(D_ > 1), BSpline<val_type, D_ - 1>>::type
+    contract_(size_type dim_ind, const std::vector<knot_type>& weights) const {
+        using reduced_type = BSpline<val_type, D_ - 1>;
+        std::array<bool, D_ - 1> periodicity;
+        std::array<size_type, D_ - 1> spline_orders;
+        std::array<size_type, D_ - 1> ctrl_sizes;
+        for (size_type d = 0, rd = 0; d < dim; ++d) {
+            if (d == dim_ind) { continue; }
+            periodicity[rd] = periodicity_[d];
+            spline_orders[rd] = orders_[d];
+            ctrl_sizes[rd] = control_points_.dim_size(d);
+            ++rd;
+        }
+
+        reduced_type reduced(periodicity, spline_orders);
+        for (size_type d = 0, rd = 0; d < dim; ++d) {
+            if (d == dim_ind) { continue; }
+            reduced.load_knots(rd++, KnotContainer(knots_[d]), uniform_[d]);
+        }
+
+        MeshDimension<D_ - 1> reduced_dimension;
+        reduced_dimension.resize(ctrl_sizes);
+        typename reduced_type::ControlPointContainer ctrl_pts(
+            reduced_dimension);
+
+        // Control points are addressed through strides, since they may be of
+        // any layout. The innermost loop runs along the last remaining
+        // dimension, which is contiguous in the row-major result.
+        const auto& src_dimension = control_points_.dimension();
+        const size_type n = src_dimension.dim_size(dim_ind);
+        const size_type step = src_dimension.stride(dim_ind);
+        const size_type last = dim_ind == dim - 1 ? dim - 2 : dim - 1;
+        const size_type inner = src_dimension.dim_size(last);
+        const size_type inner_step = src_dimension.stride(last);
+        const size_type outer = inner == 0 ? 0 : ctrl_pts.size() / inner;
+        const val_type* src = control_points_.data();
+        val_type* dst = ctrl_pts.data();
+        DimArray<size_type> ind{};
+        for (size_type o = 0; o < outer; ++o) {
+            const val_type* src_base = src + src_dimension.indexing(ind);
+            val_type* dst_line = dst + o * inner;
+            for (size_type j = 0; j < n; ++j) {
+                const knot_type w = weights[j];
+                const val_type* src_line = src_base + j * step;
+                for (size_type i = 0; i < inner; ++i) {
+                    dst_line[i] += w * src_line[i * inner_step];
+                }
+            }
+            // increase index array of other dimensions in row-major order
+            for (size_type d = dim - 1; d < dim; --d) {
+                if (d == dim_ind || d == last) { continue; }
+                if (++ind[d] < src_dimension.dim_size(d)) { break; }
+                ind[d] = 0;
+            }
+        }
+        reduced.load_ctrlPts(std::move(ctrl_pts));
+
+        return reduced;
+    }
+
+    /**
+     * @brief Take first order derivative along one dimension, by computing
+     * control points of derivative spline, which is of one order lower.
+     *
+     * @param dim_ind dimension index
+     * @param k spline order of that dimension before differentiation
+     * @param knots knots of that dimension, replaced by knots of derivative
+     * @param ctrl_pts control points, replaced by those of derivative
+     */
+    void differentiate_once_(size_type dim_ind,
+                             size_type k,
+                             KnotContainer& knots,
+                             ControlPointContainer& ctrl_pts) const {
+        const bool periodic = periodicity_[dim_ind];
+        const size_type n = ctrl_pts.dim_size(dim_ind);
+        // Periodic derivative has the same number of control points, while
+        // aperiodic one has one less.
+        const size_type diff_n = periodic ? n : n - 1;
+
+        DimArray<size_type> sizes;
+        for (size_type d = 0; d < dim; ++d) { sizes[d] = ctrl_pts.dim_size(d); }
+        sizes[dim_ind] = diff_n;
+        ControlPointContainer diff_pts(size_type{});
+        diff_pts.resize(sizes);
+
+        // Source control points may be of any layout, so both meshes are
+        // addressed through strides. The innermost loop runs along the last
+        // dimension unless it is the differentiated one.
+        const auto& src_dimension = ctrl_pts.dimension();
+        const auto& dst_dimension = diff_pts.dimension();
+        const size_type src_step = src_dimension.stride(dim_ind);
+        const size_type dst_step = dst_dimension.stride(dim_ind);
+        const bool has_inner = dim_ind != dim - 1;
+        const size_type inner = has_inner ? sizes[dim - 1] : 1;
+        const size_type src_inner_step =
+            has_inner ? src_dimension.stride(dim - 1) : 0;
+        const size_type dst_inner_step =
+            has_inner ? dst_dimension.stride(dim - 1) : 0;
+        const size_type outer =
+            n * inner == 0 ? 0 : ctrl_pts.size() / (n * inner);
+        const val_type* src = ctrl_pts.data();
+        val_type* dst = diff_pts.data();
+        DimArray<size_type> ind{};
+        for (size_type o = 0; o < outer; ++o) {
+            const val_type* src_base = src + src_dimension.indexing(ind);
+            val_type* dst_base = dst + dst_dimension.indexing(ind);
+            for (size_type j = 1; j <= diff_n; ++j) {
+                const knot_type factor =
+                    static_cast<knot_type>(k) / (knots[j + k] - knots[j]);
+                const val_type* right = src_base + (j % n) * src_step;
+                const val_type* left = src_base + (j - 1) * src_step;
+                val_type* dst_line = dst_base + (j - 1) * dst_step;
+                for (size_type i = 0; i < inner; ++i) {
+                    dst_line[i * dst_inner_step] =
+                        factor * (right[i * src_inner_step] -
+                                  left[i * src_inner_step]);
+                }
+            }
+            // increase index array of other dimensions in row-major order
+            for (size_type d = dim - 1; d < dim; --d) {
+                if (d == dim_ind || (has_inner && d == dim - 1)) { continue; }
+                if (++ind[d] < sizes[d]) { break; }
+                ind[d] = 0;
+            }
+        }
+        ctrl_pts = std::move(diff_pts);
+
+        // The first knot is dropped. Aperiodic spline drops the last knot,
+        // while periodic spline keeps knot number consistent with its order.
+        knots = KnotContainer(
+            knots.begin() + 1,
+            knots.end() - (periodic ? (k % 2 == 0 ? 2 : 0) : 1));
+    }
+
+    /**
+     * @brief Contract values along dimension d with base splines of given
+     * coordinates, i.e. evaluate the spline along that dimension. Source is
+     * addressed through strides, and destination is row-major, with size of
+     * dimension d being the number of coordinates.
+     *
+     */
+    void contract_grid_(const val_type* src,
+                        const MeshDimension<dim>& src_dimension,
+                        size_type d,
+                        const std::vector<knot_type>& coords,
+                        Mesh<val_type, dim>& dst) const {
+        const size_type o = orders_[d];
+        const size_type n = src_dimension.dim_size(d);
+        const size_type m = coords.size();
+        const size_type src_step = src_dimension.stride(d);
+        // source offsets and base spline values of each coordinate
+        std::vector<size_type> offsets(m * (o + 1));
+        std::vector<knot_type> weights(m * (o + 1));
+        size_type hint = o;
+        for (size_type i = 0; i < m; ++i) {
+            knot_type x = coords[i];
+            const auto iter = get_knot_iter(d, x, hint);
+            hint = static_cast<size_type>(iter - knots_begin(d));
+            const auto& base_spline = base_spline_value(d, iter, x);
+            for (size_type j = 0; j <= o; ++j) {
+                offsets[i * (o + 1) + j] = (hint - o + j) % n * src_step;
+                // base spline values are aligned at right
+                weights[i * (o + 1) + j] = base_spline[order - o + j];
+            }
+        }
+
+        const auto& dst_dimension = dst.dimension();
+        const size_type dst_step = dst_dimension.stride(d);
+        // The innermost loop runs along the last dimension unless it is the
+        // contracted one.
+        const bool has_inner = d != dim - 1;
+        const size_type inner = has_inner ? dst.dim_size(dim - 1) : 1;
+        const size_type src_inner_step =
+            has_inner ? src_dimension.stride(dim - 1) : 0;
+        const size_type dst_inner_step =
+            has_inner ? dst_dimension.stride(dim - 1) : 0;
+        const size_type outer =
+            m * inner == 0 ? 0 : dst.size() / (m * inner);
+        DimArray<size_type> ind{};
+        for (size_type l = 0; l < outer; ++l) {
+            const val_type* src_base = src + src_dimension.indexing(ind);
+            val_type* dst_base = dst.data() + dst_dimension.indexing(ind);
+            for (size_type i = 0; i < m; ++i) {
+                val_type* dst_line = dst_base + i * dst_step;
+                const knot_type* w = weights.data() + i * (o + 1);
+                const size_type* offset = offsets.data() + i * (o + 1);
+                if (!has_inner) {
+                    val_type v{};
+                    for (size_type j = 0; j <= o; ++j) {
+                        v += w[j] * src_base[offset[j]];
+                    }
+                    *dst_line = v;
+                    continue;
+                }
+                for (size_type j = 0; j <= o; ++j) {
+                    const val_type* src_line = src_base + offset[j];
+                    if (src_inner_step == 1 && dst_inner_step == 1) {
+                        // contiguous, e.g. row-major
+                        for (size_type k = 0; k < inner; ++k) {
+                            dst_line[k] += w[j] * src_line[k];
+                        }
+                    } else {
+                        for (size_type k = 0; k < inner; ++k) {
+                            dst_line[k * dst_inner_step] +=
+                                w[j] * src_line[k * src_inner_step];
+                        }
+                    }
+                }
+            }
+            // increase index array of other dimensions in row-major order
+            for (size_type d_ = dim - 1; d_ < dim; --d_) {
+                if (d_ == d || (has_inner && d_ == dim - 1)) { continue; }
+                if (++ind[d_] < dst.dim_size(d_)) { break; }
+                ind[d_] = 0;
+            }
+        }
+    }
+
+    /**
+     * @brief Convert local control points of one segment to coefficients of
+     * the polynomial on that segment, in power basis of (x - t_s), where t_s is
+     * the left knot of the segment. Coefficients are derivatives at t_s
+     * divided by factorials.
+     *
+     * @param dim_ind dimension index
+     * @param seg segment index, i.e. index of its left knot
+     * @param local control points c_{seg-order}, ..., c_{seg}, overwritten
+     * @param coefs output coefficients, of size order+1
+     */
+    template <typename V>
+    void to_power_basis_(size_type dim_ind,
+                         size_type seg,
+                         std::vector<V>& local,
+                         std::vector<V>& coefs) const {
+        const size_type o = orders_[dim_ind];
+        const auto seg_iter =
+            knots_begin(dim_ind) + static_cast<diff_type>(seg);
+
+        coefs.resize(o + 1);
+        knot_type factorial = 1;
+        for (size_type m = 0; m <= o; ++m) {
+            if (m > 0) {
+                // control points of m-th derivative, stored in local[m..o]
+                const auto k = static_cast<diff_type>(o - m + 1);
+                const auto last = static_cast<diff_type>(o);
+                for (diff_type j = k; j > 0; --j) {
+                    const auto idx = static_cast<size_type>(last + j - k);
+                    local[idx] = static_cast<V>(k) *
+                                 (local[idx] - local[idx - 1]) /
+                                 (seg_iter[j] - seg_iter[j - k]);
+                }
+                factorial *= static_cast<knot_type>(m);
+            }
+            const auto& base =
+                base_spline_value(dim_ind, seg_iter, *seg_iter, o - m);
+            V v{};
+            for (size_type j = m; j <= o; ++j) {
+                v += base[order - o + j] * local[j];
+            }
+            coefs[m] = v / factorial;
+        }
+    }
+
+    /**
+     * @brief Get coefficients of the polynomial on one segment of 1D spline, in
+     * power basis of (x - t_s), where t_s is the left knot of that segment.
+     *
+     * @param seg segment index, i.e. index of its left knot
+     * @param coefs output coefficients, of size order+1
+     */
+    void segment_polynomial_(size_type seg,
+                             std::vector<val_type>& coefs) const {
+        const size_type o = orders_[0];
+        const size_type n = control_points_.dim_size(0);
+        // overwritten in conversion, reused across calls of the thread
+        thread_local std::vector<val_type> local;
+        local.resize(o + 1);
+        for (size_type j = 0; j <= o; ++j) {
+            local[j] = control_points_((seg - o + j) % n);
+        }
+        to_power_basis_(0, seg, local, coefs);
+    }
+
+    /**
+     * @brief Evaluate polynomial and its derivative by Horner's method.
+     *
+     * @param coefs polynomial coefficients in power basis
+     * @param u variable
+     * @param dp derivative value
+     */
+    static val_type polynomial_value_(const std::vector<val_type>& coefs,
+                                      knot_type u,
+                                      val_type& dp) {
+        val_type p = coefs.back();
+        dp = val_type{};
+        for (size_type m = coefs.size() - 1; m-- > 0;) {
+            dp = dp * u + p;
+            p = p * u + coefs[m];
+        }
+        return p;
+    }
+
+    /**
+     * @brief Solve p(u) = y for u in [lo, hi], with p(lo) - y and p(hi) - y
+     * being of different signs. Newton iteration safeguarded by bisection is
+     * used.
+     *
+     * @param coefs polynomial coefficients in power basis
+     * @param y target value
+     * @param lo lower end of the bracket
+     * @param hi upper end of the bracket
+     */
+    static knot_type polynomial_root_(const std::vector<val_type>& coefs,
+                                      val_type y,
+                                      knot_type lo,
+                                      knot_type hi) {
+        val_type dp{};
+        const val_type r_lo = polynomial_value_(coefs, lo, dp) - y;
+        const val_type r_hi = polynomial_value_(coefs, hi, dp) - y;
+        if (r_lo == 0) { return lo; }
+        if (r_hi == 0) { return hi; }
+
+        const knot_type tol =
+            2 * std::numeric_limits<knot_type>::epsilon() * (hi - lo);
+        // start from the root of secant line
+        knot_type u = lo + (hi - lo) * r_lo / (r_lo - r_hi);
+        constexpr size_type max_iter = 64;
+        for (size_type iter = 0; iter < max_iter; ++iter) {
+            const val_type r = polynomial_value_(coefs, u, dp) - y;
+            if (r == 0) { break; }
+            ((r < 0) == (r_lo < 0) ? lo : hi) = u;
+
+            knot_type next = dp != 0 ? u - r / dp : lo;
+            // fall back to bisection if Newton step leaves the bracket
+            if (!(next > lo && next < hi)) { next = .5 * (lo + hi); }
+            if (std::abs(next - u) <= tol) {
+                u = next;
+                break;
+            }
+            u = next;
+        }
+        return u;
+    }
+
+    /**
+     * @brief Find all solutions of p(u) = y in [lo, hi]. Roots of derivative,
+     * found recursively, split the interval into monotone pieces.
+     *
+     * @param coefs polynomial coefficients in power basis
+     * @param y target value
+     * @param lo lower end of the interval
+     * @param hi upper end of the interval
+     * @param roots solutions are appended here in ascending order
+     */
+    static void polynomial_roots_(const std::vector<val_type>& coefs,
+                                  val_type y,
+                                  knot_type lo,
+                                  knot_type hi,
+                                  std::vector<knot_type>& roots) {
+        // constant polynomial has either no or infinitely many solutions
+        if (coefs.size() < 2) { return; }
+
+        // Scratch of each recursion level, indexed by degree. Deeper levels
+        // have lower degree, so they never grow the buffers in use above.
+        thread_local std::vector<std::vector<val_type>> d_coefs_buf;
+        thread_local std::vector<std::vector<knot_type>> breaks_buf;
+        if (d_coefs_buf.size() < coefs.size()) {
+            d_coefs_buf.resize(coefs.size());
+            breaks_buf.resize(coefs.size());
+        }
+        auto& d_coefs = d_coefs_buf[coefs.size() - 1];
+        auto& breaks = breaks_buf[coefs.size() - 1];
+
+        d_coefs.resize(coefs.size() - 1);
+        for (size_type m = 1; m < coefs.size(); ++m) {
+            d_coefs[m - 1] = static_cast<val_type>(m) * coefs[m];
+        }
+        breaks.assign(1, lo);
+        polynomial_roots_(d_coefs, val_type{}, lo, hi, breaks);
+        breaks.push_back(hi);
+
+        val_type dp{};
+        for (size_type i = 0; i + 1 < breaks.size(); ++i) {
+            const val_type r_lo =
+                polynomial_value_(coefs, breaks[i], dp) - y;
+            const val_type r_hi =
+                polynomial_value_(coefs, breaks[i + 1], dp) - y;
+            if (r_lo * r_hi > 0) { continue; }
+            const knot_type root =
+                polynomial_root_(coefs, y, breaks[i], breaks[i + 1]);
+            if (roots.empty() || root > roots.back()) {
+                roots.push_back(root);
+            }
+        }
+    }
+
+    /**
+     * @brief Try to solve s(x) = y in one segment of 1D spline.
+     *
+     * @param seg segment index
+     * @param y target value
+     * @param coefs buffer for segment polynomial coefficients
+     * @param x solution, if found
+     * @param exhaustive whether to look for solutions when values at segment
+     * ends do not bracket y
+     * @return whether a solution is found
+     */
+    bool solve_in_segment_(size_type seg,
+                           val_type y,
+                           std::vector<val_type>& coefs,
+                           knot_type& x,
+                           bool exhaustive = false) const {
+        const knot_type left = knots_[0][seg];
+        const knot_type h = knots_[0][seg + 1] - left;
+        if (h <= 0) { return false; }
+        segment_polynomial_(seg, coefs);
+
+        val_type dp{};
+        const val_type v_right = polynomial_value_(coefs, h, dp);
+        if ((coefs[0] - y) * (v_right - y) <= 0) {
+            x = left + polynomial_root_(coefs, y, 0, h);
+            return true;
+        }
+        if (!exhaustive) { return false; }
+
+        thread_local std::vector<knot_type> roots;
+        roots.clear();
+        polynomial_roots_(coefs, y, 0, h, roots);
+        if (roots.empty()) { return false; }
+        x = left + roots.front();
+        return true;
+    }
+
+    /**
+     * @brief Value of 1D spline at the left knot of a segment, combined from
+     * the thread-local base spline buffer without copying it.
+     *
+     * @param seg segment index, i.e. index of its left knot
+     */
+    val_type knot_value_(size_type seg) const {
+        const size_type o = orders_[0];
+        const size_type n = control_points_.dim_size(0);
+        const auto seg_iter = knots_begin(0) + static_cast<diff_type>(seg);
+        const auto& base = base_spline_value(0, seg_iter, *seg_iter);
+        val_type v{};
+        for (size_type j = 0; j <= o; ++j) {
+            v += base[order - o + j] * control_points_((seg - o + j) % n);
+        }
+        return v;
+    }
+
+    /**
+     * @brief Find x in range of 1D spline such that s(x) = y.
+     *
+     * @param y target value
+     * @param seg segment hint, updated to the segment where x locates
+     */
+    knot_type inverse_(val_type y, size_type& seg) const {
+        const size_type o = orders_[0];
+        const size_type n = control_points_.dim_size(0);
+        const size_type seg_begin = o;
+        const size_type seg_end = o + (periodicity_[0] ? n : n - o);
+        // segment polynomial, reused across calls of the thread
+        thread_local std::vector<val_type> coefs;
+        knot_type x{};
+
+        // try the segment of last solution first
+        if (seg >= seg_begin && seg < seg_end &&
+            solve_in_segment_(seg, y, coefs, x)) {
+            return x;
+        }
+
+        if (!periodicity_[0]) {
+            // Aperiodic spline is clamped, end values are the first and the
+            // last control points. Assuming the spline is monotone, segments
+            // whose control points bracket y are candidates (convex-hull
+            // property), and binary search on knot values among them finds
+            // the segment.
+            const auto c_begin = control_points_.begin();
+            const auto c_end = control_points_.end();
+            // exact at range ends, where round-off of segment polynomial may
+            // spoil the bracketing
+            if (y == *c_begin) { return range_[0].first; }
+            if (y == *(c_end - 1)) { return range_[0].second; }
+            const bool increasing = *(c_end - 1) >= *c_begin;
+            const auto lower =
+                increasing ? std::lower_bound(c_begin, c_end, y)
+                           : std::lower_bound(c_begin, c_end, y,
+                                              std::greater<val_type>{});
+            const auto upper =
+                increasing ? std::upper_bound(c_begin, c_end, y)
+                           : std::upper_bound(c_begin, c_end, y,
+                                              std::greater<val_type>{});
+            if (lower != c_end && upper != c_begin) {
+                size_type l = std::max(
+                    seg_begin, static_cast<size_type>(lower - c_begin));
+                size_type r = std::min(
+                    seg_end - 1,
+                    static_cast<size_type>(upper - c_begin) - 1 + o);
+                while (l < r) {
+                    const size_type mid = (l + r + 1) / 2;
+                    const val_type v = knot_value_(mid);
+                    if (increasing ? v <= y : v >= y) {
+                        l = mid;
+                    } else {
+                        r = mid - 1;
+                    }
+                }
+                if (l < seg_end && solve_in_segment_(l, y, coefs, x)) {
+                    seg = l;
+                    return x;
+                }
+            }
+        }
+
+        // Fall back to scanning all segments, skipping those whose control
+        // points do not bracket y.
+        for (size_type s = seg_begin; s < seg_end; ++s) {
+            val_type c_min = control_points_((s - o) % n);
+            val_type c_max = c_min;
+            for (size_type j = s - o + 1; j <= s; ++j) {
+                c_min = std::min(c_min, control_points_(j % n));
+                c_max = std::max(c_max, control_points_(j % n));
+            }
+            if (y < c_min || y > c_max) { continue; }
+            if (solve_in_segment_(s, y, coefs, x, true)) {
+                seg = s;
+                return x;
+            }
+        }
+
+        throw std::domain_error("Given value out of spline range!");
+    }
+
    public:
     /**
      * @brief Construct a new BSpline object, with periodicity of each dimension
@@ -214,9 +973,23 @@ class BSpline {
         : order(spline_order),
           periodicity_(periodicity),
           control_points_(size_type{}),
-          base_spline_buf_(order + 1, 0),
           buf_size_(util::pow(order + 1, dim)) {
         uniform_.fill(true);
+        orders_.fill(order);
+    }
+
+    /**
+     * @brief Construct a new BSpline object, with periodicity and order of each
+     * dimension specified.
+     *
+     */
+    BSpline(DimArray<bool> periodicity, DimArray<size_type> spline_orders)
+        : order(*std::max_element(spline_orders.begin(), spline_orders.end())),
+          periodicity_(periodicity),
+          orders_(spline_orders),
+          control_points_(size_type{}),
+          buf_size_(local_size_(spline_orders)) {
+        uniform_.fill(true);
     }
 
     /**
@@ -237,7 +1010,6 @@ class BSpline {
           knots_{
               KnotContainer(knot_iter_pairs.first, knot_iter_pairs.second)...},
           control_points_(std::move(ctrl_points)),
-          base_spline_buf_(order + 1, 0),
           range_{std::make_pair(
               (knot_iter_pairs.first)[order],
               (knot_iter_pairs.second)[-static_cast<int>(order) - 1])...},
@@ -251,6 +1023,7 @@ class BSpline {
             }
         }
         uniform_.fill(true);
+        orders_.fill(order);
     }
 
     template <typename... InputIters>
@@ -268,10 +1041,13 @@ class BSpline {
                      KnotContainer>::value,
         void>::type
     load_knots(size_type dim_ind, C&& _knots, bool is_uniform = false) {
+        const size_type o = orders_[dim_ind];
         knots_[dim_ind] = std::forward<C>(_knots);
-        range_[dim_ind].first = knots_[dim_ind][order];
+        range_[dim_ind].first = knots_[dim_ind][o];
+        // Periodic spline of even order has one more knot at the end.
         range_[dim_ind].second =
-            knots_[dim_ind][knots_[dim_ind].size() - order - (2 - order % 2)];
+            knots_[dim_ind][knots_[dim_ind].size() - o -
+                            (periodicity_[dim_ind] ? 2 - o % 2 : 1)];
         uniform_[dim_ind] = is_uniform;
     }
 
@@ -284,6 +1060,21 @@ class BSpline {
         control_points_ = std::forward<C>(_control_points);
     }
 
+    /**
+     * @brief Load control points from a view of external storage of any
+     * layout, copied into the row-major control point mesh. Use a MeshView as
+     * control point container to refer to the storage instead.
+     *
+     */
+    template <typename U, typename C = ControlPointContainer>
+    typename std::enable_if<
+        std::is_same<C, Mesh<val_type, dim>>::value &&
+            std::is_same<typename std::remove_const<U>::type, val_type>::value,
+        void>::type
+    load_ctrlPts(const MeshView<U, dim>& _control_points) {
+        control_points_ = ControlPointContainer{_control_points};
+    }
+
     /**
      * @brief Get spline value at given pairs of coordinate and position hint
      * (hopefully lower knot point index of the segment where coordinate
@@ -306,48 +1097,109 @@ class BSpline {
         // get knot point iter, it will modifies coordinate value into
         // interpolation range of periodic dimension.
         const auto knot_iters = get_knot_iters(Indices{}, coord_with_hints...);
+        return value_at_(
+            Indices{}, knot_iters,
+            DimArray<knot_type>{
+                static_cast<knot_type>(coord_with_hints.first)...});
+    }
 
-        DimArray<size_type> spline_order;
-        spline_order.fill(order);
-        // calculate basic spline (out of boundary check also conducted here)
-        const auto base_spline_values_1d = calc_base_spline_vals(
-            Indices{}, knot_iters, spline_order, coord_with_hints.first...);
-
-        // combine control points and basic spline values to get spline value
-        val_type v{};
-        for (size_type i = 0; i < buf_size_; ++i) {
-            DimArray<size_type> ind_arr;
-            for (size_type d = 0, combined_ind = i; d < dim; ++d) {
-                ind_arr[d] = combined_ind % (order + 1);
-                combined_ind /= (order + 1);
-            }
-
-            val_type coef = 1;
+    /**
+     * @brief Evaluate spline at a batch of points, pipelined: knots of the
+     * point `lookahead` positions ahead are searched and its control points
+     * are prefetched while the current point is computed, so that fetching
+     * control points from memory (or from disk, for ChunkedMesh) overlaps
+     * with computing base splines.
+     *
+     * @param first, last range of points, each of which has coordinates of
+     * all dimensions accessed by subscript
+     * @param d_first beginning of the destination range
+     * @param lookahead number of points looked up in advance, zero means no
+     * pipelining
+     * @param hint a callable giving position hint of a coordinate, by
+     * dimension index and coordinate value
+     * @return output iterator to the element past the last one written
+     */
+    template <typename InputIter, typename OutputIter, typename HintFunc>
+    OutputIter evaluate(InputIter first,
+                        InputIter last,
+                        OutputIter d_first,
+                        size_type lookahead,
+                        HintFunc&& hint) const {
+        struct Stage {
+            DimArray<knot_type> coord;
+            DimArray<KnotContainer::const_iterator> knot_iters;
+        };
+        std::vector<Stage> stages(lookahead + 1);
+        const auto look_up = [&](InputIter it, Stage& stage) {
             for (size_type d = 0; d < dim; ++d) {
-                coef *= base_spline_values_1d[d][ind_arr[d]];
-
-                // Shift index array according to knot iter of each dimension.
-                // When the coordinate is out of range in some dimensions, the
-                // corresponding iterator was set to be begin or end iterator of
-                // knot vector in `get_knot_iters` method and it will be treated
-                // separately.
-                ind_arr[d] += knot_iters[d] == knots_begin(d) ? 0
-                              : knot_iters[d] == knots_end(d)
-                                  ? control_points_.dim_size(d) - order - 1
-                                  : static_cast<size_type>(distance(
-                                        knots_begin(d), knot_iters[d])) -
-                                        order;
-
-                // check periodicity, put out-of-right-boundary index to left
-                if (periodicity_[d]) {
-                    ind_arr[d] %= control_points_.dim_size(d);
-                }
+                stage.coord[d] = static_cast<knot_type>((*it)[d]);
+                stage.knot_iters[d] = get_knot_iter(
+                    d, stage.coord[d],
+                    static_cast<size_type>(hint(d, stage.coord[d])));
             }
+            prefetch_stencil_(stencil_begin_(stage.knot_iters), 0);
+        };
 
-            v += coef * control_points_(ind_arr);
+        // fill the pipeline
+        auto ahead = first;
+        for (size_type i = 0; i < lookahead && ahead != last; ++i, ++ahead) {
+            look_up(ahead, stages[i]);
+        }
+        for (size_type i = 0; first != last; ++first, ++i) {
+            if (ahead != last) {
+                look_up(ahead, stages[(i + lookahead) % stages.size()]);
+                ++ahead;
+            }
+            const auto& stage = stages[i % stages.size()];
+            *d_first++ = value_at_(util::make_index_sequence<dim>{},
+                                   stage.knot_iters, stage.coord);
         }
+        return d_first;
+    }
 
-        return v;
+    /**
+     * @brief Evaluate spline at a batch of points, pipelined, without
+     * position hints.
+     *
+     */
+    template <typename InputIter, typename OutputIter>
+    OutputIter evaluate(InputIter first,
+                        InputIter last,
+                        OutputIter d_first,
+                        size_type lookahead = 8) const {
+        return evaluate(first, last, d_first, lookahead,
+                        [this](size_type, knot_type) { return order; });
+    }
+
+    /**
+     * @brief Evaluate spline on a Cartesian grid, one dimension at a time:
+     * control points are contracted with base splines of the grid
+     * coordinates of the first dimension, then of the second, and so on. It
+     * costs about (order + 1) * dim operations per grid point, instead of
+     * (order + 1)^dim of pointwise evaluation.
+     *
+     * @param grid ascending coordinates of each dimension
+     * @return values on grid, in a row-major mesh
+     */
+    Mesh<val_type, dim> evaluate_grid(
+        const DimArray<std::vector<knot_type>>& grid) const {
+        DimArray<size_type> sizes;
+        for (size_type d = 0; d < dim; ++d) {
+            sizes[d] = control_points_.dim_size(d);
+        }
+        Mesh<val_type, dim> values(size_type{});
+        const val_type* src = control_points_.data();
+        MeshDimension<dim> src_dimension = control_points_.dimension();
+        for (size_type d = 0; d < dim; ++d) {
+            sizes[d] = grid[d].size();
+            Mesh<val_type, dim> contracted(size_type{});
+            contracted.resize(sizes);
+            contract_grid_(src, src_dimension, d, grid[d], contracted);
+            values = std::move(contracted);
+            src = values.data();
+            src_dimension = values.dimension();
+        }
+        return values;
     }
 
     /**
@@ -384,14 +1236,15 @@ class BSpline {
                                 CoordDeriOrderHintTuple...>::type>::value == 3,
                             val_type>::type
     derivative_at(CoordDeriOrderHintTuple... coord_deriOrder_hint_tuple) const {
+        INTP_COUNT(derivative_evaluations);
         // get spline order
-        DimArray<size_type> spline_order{
-            (order >= std::get<1>(coord_deriOrder_hint_tuple)
-                 ? order - std::get<1>(coord_deriOrder_hint_tuple)
-                 : order + 1)...};
-        // if derivative order is larger than spline order, derivative is 0.
-        for (auto o : spline_order) {
-            if (o > order) { return val_type{}; }
+        const DimArray<size_type> deri_order{static_cast<size_type>(
+            std::get<1>(coord_deriOrder_hint_tuple))...};
+        DimArray<size_type> spline_order;
+        for (size_type d = 0; d < dim; ++d) {
+            // if derivative order is larger than spline order, derivative is 0.
+            if (deri_order[d] > orders_[d]) { return val_type{}; }
+            spline_order[d] = orders_[d] - deri_order[d];
         }
 
         // get knot point iter
@@ -418,30 +1271,32 @@ class BSpline {
         auto local_spline_val = local_control_points;
 #endif
 
-        // get local control points and basic spline values
+        // Get local control points and basic spline values. Local buffers are
+        // of size (order+1)^dim, and dimensions of lower order are aligned at
+        // right, same as base spline values.
         for (size_type i = 0; i < buf_size_; ++i) {
             DimArray<size_type> local_ind_arr{};
+            DimArray<size_type> ind_arr{};
             for (size_type d = 0, combined_ind = i; d < dim; ++d) {
-                local_ind_arr[d] = combined_ind % (order + 1);
-                combined_ind /= (order + 1);
+                ind_arr[d] = combined_ind % (orders_[d] + 1);
+                local_ind_arr[d] = order - orders_[d] + ind_arr[d];
+                combined_ind /= (orders_[d] + 1);
             }
 
             val_type coef = 1;
-            DimArray<size_type> ind_arr{};
             for (size_type d = 0; d < dim; ++d) {
                 coef *= base_spline_values_1d[d][local_ind_arr[d]];
 
-                ind_arr[d] = local_ind_arr[d] +
-                             (knot_iters[d] == knots_begin(d) ? 0
+                ind_arr[d] += knot_iters[d] == knots_begin(d) ? 0
                               : knot_iters[d] == knots_end(d)
-                                  ? control_points_.dim_size(d) - order - 1
+                                  ? control_points_.dim_size(d) - orders_[d] - 1
                                   : static_cast<size_t>(distance(
                                         knots_begin(d), knot_iters[d])) -
-                                        order);
+                                        orders_[d];
 
                 // check periodicity, put out-of-right-boundary index to left
                 if (periodicity_[d]) {
-                    ind_arr[d] %= (knots_num(d) - 2 * order - 1);
+                    ind_arr[d] %= control_points_.dim_size(d);
                 }
             }
 
@@ -450,7 +1305,7 @@ class BSpline {
         }
 
         for (size_type d = 0; d < dim; ++d) {
-            if (spline_order[d] == order) { continue; }
+            if (spline_order[d] == orders_[d]) { continue; }
             // calculate control points for derivative along this dimension
 
             const size_type hyper_surface_size =
@@ -467,7 +1322,7 @@ class BSpline {
                 auto iter = local_control_points.begin(d, local_ind_arr);
                 // Taking derivative is effectively computing new control
                 // points. Number of iteration is order of derivative.
-                for (diff_type k = static_cast<diff_type>(order);
+                for (diff_type k = static_cast<diff_type>(orders_[d]);
                      k > static_cast<diff_type>(spline_order[d]); --k) {
                     // Each reduction reduce control points number by one.
                     // Reduce backward to match pattern of local_spline_val.
@@ -511,6 +1366,249 @@ class BSpline {
                             static_cast<size_type>(coords.second), order)...);
     }
 
+    /**
+     * @brief Get a new spline representing partial derivative of this spline.
+     * Control points of the derivative spline are computed once, thus
+     * derivative of the same order can be evaluated as fast as spline value.
+     *
+     * @param deri_orders derivative order of each dimension
+     * @return a BSpline of lower order in differentiated dimensions
+     */
+    BSpline differentiate(const DimArray<size_type>& deri_orders) const {
+        DimArray<size_type> spline_orders = orders_;
+        auto knots = knots_;
+        auto ctrl_pts = control_points_;
+        for (size_type d = 0; d < dim; ++d) {
+            for (size_type n = 0; n < deri_orders[d]; ++n) {
+                if (spline_orders[d] == 0) {
+                    // derivative of piecewise constant spline is zero
+                    std::fill(ctrl_pts.data(),
+                              ctrl_pts.data() + ctrl_pts.dimension().extent(),
+                              val_type{});
+                    break;
+                }
+                differentiate_once_(d, spline_orders[d]--, knots[d], ctrl_pts);
+            }
+        }
+
+        BSpline derivative(periodicity_, spline_orders);
+        for (size_type d = 0; d < dim; ++d) {
+            derivative.load_knots(d, std::move(knots[d]), uniform_[d]);
+        }
+        derivative.load_ctrlPts(std::move(ctrl_pts));
+        return derivative;
+    }
+
+    /**
+     * @brief Get definite integrals of base splines of one dimension over an
+     * interval. Integrals of base splines multiplying the same control point
+     * (in periodic dimension) are summed up.
+     *
+     * @param dim_ind dimension index
+     * @param a lower limit
+     * @param b upper limit
+     * @return a vector of integral values, indexed by control point
+     */
+    std::vector<knot_type> base_spline_integral(size_type dim_ind,
+                                                knot_type a,
+                                                knot_type b) const {
+        std::vector<knot_type> weights(control_points_.dim_size(dim_ind), 0);
+        const auto& r = range(dim_ind);
+        if (periodicity_[dim_ind]) {
+            // Integral over [a, b] is decomposed into several whole periods
+            // plus integral between the wrapped coordinates.
+            const knot_type period = r.second - r.first;
+            const knot_type period_diff =
+                std::floor((b - r.first) / period) -
+                std::floor((a - r.first) / period);
+            accumulate_base_spline_primitive_(
+                dim_ind,
+                r.first + (b - r.first) -
+                    period * std::floor((b - r.first) / period),
+                1, weights);
+            accumulate_base_spline_primitive_(
+                dim_ind,
+                r.first + (a - r.first) -
+                    period * std::floor((a - r.first) / period),
+                -1, weights);
+            if (period_diff != 0) {
+                accumulate_base_spline_primitive_(dim_ind, r.second,
+                                                  period_diff, weights);
+                accumulate_base_spline_primitive_(dim_ind, r.first,
+                                                  -period_diff, weights);
+            }
+        } else {
+            if (std::min(a, b) < r.first || std::max(a, b) > r.second) {
+                throw std::domain_error(
+                    "Given integration range out of spline range!");
+            }
+            accumulate_base_spline_primitive_(dim_ind, b, 1, weights);
+            accumulate_base_spline_primitive_(dim_ind, a, -1, weights);
+        }
+        return weights;
+    }
+
+    /**
+     * @brief Get definite integral of spline function over a box, i.e. a
+     * Cartesian product of intervals of each dimension. The integral is
+     * separated dimension-wise, so it costs O(number of control points).
+     *
+     * @param box lower and upper limits of each dimension
+     * @return val_type
+     */
+    val_type integrate(
+        const DimArray<std::pair<knot_type, knot_type>>& box) const {
+        DimArray<std::vector<knot_type>> weights;
+        for (size_type d = 0; d < dim; ++d) {
+            weights[d] = base_spline_integral(d, box[d].first, box[d].second);
+        }
+
+        // contract control points with integrals of base spline
+        val_type v{};
+        DimArray<size_type> ind_arr{};
+        for (size_type i = 0; i < control_points_.size(); ++i) {
+            val_type coef = 1;
+            for (size_type d = 0; d < dim; ++d) {
+                coef *= weights[d][ind_arr[d]];
+            }
+            v += coef * control_points_(ind_arr);
+
+            // increase index array in row-major order
+            for (size_type d = dim - 1; d < dim; --d) {
+                if (++ind_arr[d] < control_points_.dim_size(d)) { break; }
+                ind_arr[d] = 0;
+            }
+        }
+        return v;
+    }
+
+    /**
+     * @brief Get definite integral of spline function over its whole range.
+     *
+     */
+    val_type integrate() const { return integrate(range_); }
+
+    /**
+     * @brief Get definite integral along one dimension, the result is a spline
+     * of one dimension lower.
+     *
+     * @param dim_ind dimension index
+     * @param a lower limit
+     * @param b upper limit
+     */
+    template <size_type D_ = dim>
+    typename std::enable_if<(D_ > 1), BSpline<val_type, D_ - 1>>::type
+    integrate_along(size_type dim_ind, knot_type a, knot_type b) const {
+        return contract_(dim_ind, base_spline_integral(dim_ind, a, b));
+    }
+
+    /**
+     * @brief Fix coordinate of one dimension, the result is a spline of one
+     * dimension lower, whose control points are contracted with base spline
+     * values at that coordinate.
+     *
+     * @param dim_ind dimension index
+     * @param x coordinate
+     * @param hint hint of knot index, see `get_knot_iter`
+     */
+    template <size_type D_ = dim>
+    typename std::enable_if<(D_ > 1), BSpline<val_type, D_ - 1>>::type
+    bind(size_type dim_ind, knot_type x, size_type hint) const {
+        const auto iter = get_knot_iter(dim_ind, x, hint);
+        const auto& base_spline = base_spline_value(dim_ind, iter, x);
+        const size_type o = orders_[dim_ind];
+        const size_type n = control_points_.dim_size(dim_ind);
+        const size_type begin =
+            static_cast<size_type>(iter - knots_begin(dim_ind)) - o;
+
+        std::vector<knot_type> weights(n, 0);
+        for (size_type j = 0; j <= o; ++j) {
+            // base spline values are aligned at right
+            weights[(begin + j) % n] += base_spline[order - o + j];
+        }
+        return contract_(dim_ind, weights);
+    }
+
+    /**
+     * @brief Get the antiderivative of 1D spline, which vanishes at the lower
+     * end of range. It is an aperiodic spline of one order higher, on the same
+     * knot vector but with both ends repeated once more. In periodic case it is
+     * valid on the whole unwrapped knot vector.
+     *
+     */
+    template <size_type D_ = dim>
+    typename std::enable_if<D_ == 1, BSpline>::type antiderivative() const {
+        KnotContainer knots;
+        knots.reserve(knots_num(0) + 2);
+        knots.push_back(knots_[0].front());
+        knots.insert(knots.end(), knots_[0].begin(), knots_[0].end());
+        knots.push_back(knots_[0].back());
+
+        // Antiderivative starting from the beginning of knot vector has control
+        // points being partial sums of integrals of each base spline.
+        const size_type ctrl_num = control_points_.dim_size(0);
+        const size_type base_num = knots_num(0) - order - 1;
+        ControlPointContainer ctrl_pts(base_num + 1);
+        ctrl_pts(0) = val_type{};
+        for (size_type i = 0; i < base_num; ++i) {
+            ctrl_pts(i + 1) =
+                ctrl_pts(i) + control_points_(i % ctrl_num) *
+                                  (knots_[0][i + order + 1] - knots_[0][i]) /
+                                  static_cast<knot_type>(order + 1);
+        }
+
+        // shift it to vanish at the lower end of range
+        std::vector<knot_type> weights(ctrl_num, 0);
+        accumulate_base_spline_primitive_(0, range(0).first, 1, weights);
+        val_type offset{};
+        for (size_type i = 0; i < ctrl_num; ++i) {
+            offset += weights[i] * control_points_(i);
+        }
+        for (size_type i = 0; i <= base_num; ++i) { ctrl_pts(i) -= offset; }
+
+        return BSpline(order + 1, std::move(ctrl_pts),
+                       std::make_pair(knots.cbegin(), knots.cend()));
+    }
+
+    /**
+     * @brief Find x such that s(x) = y for 1D spline, by solving polynomial
+     * equation on the segment where solution locates. The spline is supposed
+     * to be monotone, otherwise one of the solutions is returned.
+     *
+     * @param y target value
+     * @return knot_type
+     */
+    template <size_type D_ = dim>
+    typename std::enable_if<D_ == 1, knot_type>::type inverse(
+        val_type y) const {
+        size_type seg = orders_[0];
+        return inverse_(y, seg);
+    }
+
+    /**
+     * @brief Find x for a batch of target values. The segment where last
+     * solution locates is checked first, thus sorted target values are solved
+     * faster.
+     *
+     * @param first begin iterator of target values
+     * @param last end iterator of target values
+     * @param d_first begin iterator of output
+     * @return output iterator to the element past the last one written
+     */
+    template <typename InputIter,
+              typename OutputIter,
+              size_type D_ = dim,
+              typename = typename std::enable_if<D_ == 1>::type>
+    OutputIter inverse(InputIter first,
+                       InputIter last,
+                       OutputIter d_first) const {
+        size_type seg = orders_[0];
+        for (; first != last; ++first, ++d_first) {
+            *d_first = inverse_(static_cast<val_type>(*first), seg);
+        }
+        return d_first;
+    }
+
     // iterators
 
     /**
@@ -571,6 +1669,14 @@ class BSpline {
         return uniform_[dim_ind];
     }
 
+    /**
+     * @brief Get spline order of one dimension, which may be lower than the
+     * (maximum) order of spline.
+     *
+     * @param dim_ind dimension index
+     */
+    size_type dim_order(size_type dim_ind) const { return orders_[dim_ind]; }
+
 #ifdef _DEBUG
     void __debug_output() const {
         std::cout << "\n[DEBUG] Control Points (raw data):\n";
@@ -1,7 +1,12 @@
 #ifndef INTP_BANDLU
 #define INTP_BANDLU
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 #include <type_traits>
+#include <vector>
 
 #include "BandMatrix.hpp"
 #include "util.hpp"
@@ -16,6 +21,7 @@ template <template <typename> class Solver, typename Matrix>
 class BandLUBase : public util::CRTP<Solver<Matrix>> {
    public:
     using matrix_type = Matrix;
+    using val_type = typename matrix_type::val_type;
 
     BandLUBase() noexcept : is_computed_(false) {}
 
@@ -34,7 +40,7 @@ class BandLUBase : public util::CRTP<Solver<Matrix>> {
             std::is_same<util::remove_cvref_t<Mat_>, matrix_type>::value,
             "Matrix type mismatch");
         if (!is_computed_) {
-            lu_store_ = std::forward<matrix_type>(mat);
+            lu_store_ = std::forward<Mat_>(mat);
             this->cast().compute_impl();
             is_computed_ = true;
         }
@@ -53,10 +59,68 @@ class BandLUBase : public util::CRTP<Solver<Matrix>> {
         this->cast().solve_in_place_impl(iter);
     }
 
+    /**
+     * @brief Solve for several right hand sides at once. They are stored in a
+     * block of rows, the i-th row holding the i-th elements of all right hand
+     * sides contiguously, so that the innermost loop of a dedicated
+     * implementation runs across right hand sides and is vectorized.
+     *
+     * @param block pointer to the first row
+     * @param pitch distance between the beginnings of adjacent rows
+     * @param width number of right hand sides
+     */
+    template <typename U>
+    void solve_block_in_place(U* block,
+                              std::size_t pitch,
+                              std::size_t width) const {
+        this->cast().solve_block_in_place_impl(block, pitch, width);
+    }
+
+    /**
+     * @brief Upper bound of the infinity norm of inverse matrix, i.e. of the
+     * largest absolute row sum of A^{-1}, computed from the factorization in
+     * time linear to dimension.
+     *
+     */
+    val_type inverse_norm_bound() const {
+        return this->cast().inverse_norm_bound_impl();
+    }
+
    protected:
     bool is_computed_;
     matrix_type lu_store_;
 
+    /**
+     * @brief Fallback of block solving. The block is transposed into a
+     * buffer, where each right hand side is solved alone, and transposed
+     * back.
+     *
+     */
+    template <typename U>
+    void solve_block_in_place_impl(U* block,
+                                   std::size_t pitch,
+                                   std::size_t width) const {
+        const std::size_t n = lu_store_.dim();
+        thread_local std::vector<U> buffer;
+        buffer.resize(n * width);
+        for (std::size_t i = 0; i < n; ++i) {
+            const U* row = block + i * pitch;
+            for (std::size_t w = 0; w < width; ++w) {
+                buffer[w * n + i] = row[w];
+            }
+        }
+        for (std::size_t w = 0; w < width; ++w) {
+            solve_in_place(buffer.begin() +
+                           static_cast<std::ptrdiff_t>(w * n));
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            U* row = block + i * pitch;
+            for (std::size_t w = 0; w < width; ++w) {
+                row[w] = buffer[w * n + i];
+            }
+        }
+    }
+
     // Get the type of parameter in array subscript operator of given type U. It
     // is assumed that type U is either a container () of an iterator.
     template <typename U>
@@ -80,6 +144,7 @@ class BandLU<BandMatrix<T>> : public BandLUBase<BandLU, BandMatrix<T>> {
     using base_type = BandLUBase<intp::BandLU, BandMatrix<T>>;
     using matrix_type = BandMatrix<T>;
     using size_type = typename matrix_type::size_type;
+    using val_type = typename matrix_type::val_type;
 
    private:
     friend base_type;
@@ -127,6 +192,61 @@ class BandLU<BandMatrix<T>> : public BandLUBase<BandLU, BandMatrix<T>> {
             }
         }
     }
+
+    template <typename U>
+    void solve_block_in_place_impl(U* block,
+                                   size_type pitch,
+                                   size_type width) const {
+        size_type n = lu_store_.dim();
+        size_type p = lu_store_.lower_band_width();
+        size_type q = lu_store_.upper_band_width();
+
+        // row_i -= a * row_j, across all right hand sides
+        const auto eliminate = [&](size_type i, size_type j, U a) {
+            U* row_i = block + i * pitch;
+            const U* row_j = block + j * pitch;
+            for (size_type w = 0; w < width; ++w) { row_i[w] -= a * row_j[w]; }
+        };
+        // applying l matrix
+        for (size_type j = 0; j < n; ++j) {
+            for (size_type i = j + 1; i < std::min(j + p + 1, n); ++i) {
+                eliminate(i, j, lu_store_(i, j));
+            }
+        }
+        // applying u matrix
+        for (size_type j = n - 1; j < n; --j) {
+            U* row_j = block + j * pitch;
+            const U diag = lu_store_(j, j);
+            for (size_type w = 0; w < width; ++w) { row_j[w] /= diag; }
+            for (size_type i = j < q ? 0 : j - q; i < j; ++i) {
+                eliminate(i, j, lu_store_(i, j));
+            }
+        }
+    }
+
+    // Elementwise |A^{-1}| <= |U^{-1}| |L^{-1}| <= M(U)^{-1} M(L)^{-1}, where
+    // M is the comparison matrix (absolute diagonal and negated absolute
+    // off-diagonal elements), so the bound is the largest element of
+    // M(U)^{-1} M(L)^{-1} e, i.e. solving for all ones with signs ignored.
+    val_type inverse_norm_bound_impl() const {
+        size_type n = lu_store_.dim();
+        size_type p = lu_store_.lower_band_width();
+        size_type q = lu_store_.upper_band_width();
+
+        std::vector<val_type> x(n, val_type{1});
+        for (size_type j = 0; j < n; ++j) {
+            for (size_type i = j + 1; i < std::min(j + p + 1, n); ++i) {
+                x[i] += std::abs(lu_store_(i, j)) * x[j];
+            }
+        }
+        for (size_type j = n - 1; j < n; --j) {
+            x[j] /= std::abs(lu_store_(j, j));
+            for (size_type i = j < q ? 0 : j - q; i < j; ++i) {
+                x[i] += std::abs(lu_store_(i, j)) * x[j];
+            }
+        }
+        return *std::max_element(x.begin(), x.end());
+    }
 };
 
 template <typename T>
@@ -136,6 +256,7 @@ class BandLU<ExtendedBandMatrix<T>>
     using base_type = BandLUBase<intp::BandLU, ExtendedBandMatrix<T>>;
     using matrix_type = ExtendedBandMatrix<T>;
     using size_type = typename matrix_type::size_type;
+    using val_type = typename matrix_type::val_type;
 
    private:
     friend base_type;
@@ -243,6 +364,608 @@ class BandLU<ExtendedBandMatrix<T>>
             }
         }
     }
+
+    template <typename U>
+    void solve_block_in_place_impl(U* block,
+                                   size_type pitch,
+                                   size_type width) const {
+        size_type n = lu_store_.dim();
+        size_type p = lu_store_.lower_band_width();
+        size_type q = lu_store_.upper_band_width();
+
+        // row_i -= a * row_j, across all right hand sides
+        const auto eliminate = [&](size_type i, size_type j, U a) {
+            U* row_i = block + i * pitch;
+            const U* row_j = block + j * pitch;
+            for (size_type w = 0; w < width; ++w) { row_i[w] -= a * row_j[w]; }
+        };
+        // apply l matrix
+        for (size_type j = 0; j < n; ++j) {
+            for (size_type i = j + 1; i < std::min(j + p + 1, n); ++i) {
+                eliminate(i, j, lu_store_.main_bands_val(i, j));
+            }
+
+            // bottom side bands
+            if (j < n - p - 1) {
+                for (size_type i = std::max(n - q, j + p + 1); i < n; ++i) {
+                    eliminate(i, j, lu_store_.side_bands_val(i, j));
+                }
+            }
+        }
+        // apply u matrix
+        for (size_type j = n - 1; j < n; --j) {
+            U* row_j = block + j * pitch;
+            const U diag = lu_store_.main_bands_val(j, j);
+            for (size_type w = 0; w < width; ++w) { row_j[w] /= diag; }
+            for (size_type i = j < q ? 0 : j - q; i < j; ++i) {
+                eliminate(i, j, lu_store_.main_bands_val(i, j));
+            }
+
+            // right side bands
+            if (j > n - p - 1) {
+                for (size_type i = 0; i < j - q; ++i) {
+                    eliminate(i, j, lu_store_.side_bands_val(i, j));
+                }
+            }
+        }
+    }
+
+    // the same comparison matrix bound as BandLU<BandMatrix>, side bands
+    // included
+    val_type inverse_norm_bound_impl() const {
+        size_type n = lu_store_.dim();
+        size_type p = lu_store_.lower_band_width();
+        size_type q = lu_store_.upper_band_width();
+
+        std::vector<val_type> x(n, val_type{1});
+        for (size_type j = 0; j < n; ++j) {
+            for (size_type i = j + 1; i < std::min(j + p + 1, n); ++i) {
+                x[i] += std::abs(lu_store_.main_bands_val(i, j)) * x[j];
+            }
+            if (j < n - p - 1) {
+                for (size_type i = std::max(n - q, j + p + 1); i < n; ++i) {
+                    x[i] += std::abs(lu_store_.side_bands_val(i, j)) * x[j];
+                }
+            }
+        }
+        for (size_type j = n - 1; j < n; --j) {
+            x[j] /= std::abs(lu_store_.main_bands_val(j, j));
+            for (size_type i = j < q ? 0 : j - q; i < j; ++i) {
+                x[i] += std::abs(lu_store_.main_bands_val(i, j)) * x[j];
+            }
+            if (j > n - p - 1) {
+                for (size_type i = 0; i < j - q; ++i) {
+                    x[i] += std::abs(lu_store_.side_bands_val(i, j)) * x[j];
+                }
+            }
+        }
+        return *std::max_element(x.begin(), x.end());
+    }
+};
+
+/**
+ * @brief Solver for symmetric circulant band matrix, e.g. the coefficient
+ * matrix of periodic interpolation on uniform grid. The symbol of matrix,
+ * $c(z)=\sum_k c_k z^k$, is factorized into
+ * $\alpha\prod_j(1-r_j z)(1-r_j/z)$ with $|r_j|<1$, i.e. the matrix is a
+ * product of cyclic lower and upper bidiagonal matrices. Solving is then a
+ * causal and an anti-causal first order recursion for each r_j, followed by a
+ * division by alpha.
+ *
+ */
+template <typename T>
+class BandLU<CirculantBandMatrix<T>>
+    : public BandLUBase<BandLU, CirculantBandMatrix<T>> {
+   public:
+    using base_type = BandLUBase<intp::BandLU, CirculantBandMatrix<T>>;
+    using matrix_type = CirculantBandMatrix<T>;
+    using size_type = typename matrix_type::size_type;
+    using val_type = typename matrix_type::val_type;
+
+    BandLU() = default;
+
+    // Factorization results are stored in members of this class, so it can not
+    // be done in base class constructor.
+    template <typename Mat_>
+    BandLU(Mat_&& mat) {
+        this->compute(std::forward<Mat_>(mat));
+    }
+
+   private:
+    friend base_type;
+    using base_type::lu_store_;
+
+    // r_j in the factorization
+    std::vector<val_type> poles_;
+    // number of terms needed to initialize recursion of each pole
+    std::vector<size_type> init_len_;
+    val_type gain_{};
+
+    /**
+     * @brief Evaluate polynomial with coefficients given in ascending order,
+     * and its derivative.
+     *
+     */
+    static val_type polynomial_value_(const std::vector<val_type>& coefs,
+                                      val_type x,
+                                      val_type& dp) {
+        val_type p = coefs.back();
+        dp = val_type{};
+        for (size_type i = coefs.size() - 1; i-- > 0;) {
+            dp = dp * x + p;
+            p = p * x + coefs[i];
+        }
+        return p;
+    }
+
+    static val_type newton_(const std::vector<val_type>& coefs, val_type x) {
+        for (size_type iter = 0; iter < 100; ++iter) {
+            val_type dp;
+            const val_type p = polynomial_value_(coefs, x, dp);
+            if (dp == val_type{}) { break; }
+            const val_type step = p / dp;
+            x -= step;
+            if (std::abs(step) <=
+                std::numeric_limits<val_type>::epsilon() * std::abs(x)) {
+                break;
+            }
+        }
+        return x;
+    }
+
+    void compute_impl() {
+        const size_type b = lu_store_.lower_band_width();
+        const size_type n = lu_store_.dim();
+        // symmetric up to round-off error
+        for (size_type k = 1; k <= b; ++k) {
+            const auto kd = static_cast<std::ptrdiff_t>(k);
+            if (b != lu_store_.upper_band_width() ||
+                std::abs(lu_store_.diagonal(kd) - lu_store_.diagonal(-kd)) >
+                    64 * std::numeric_limits<val_type>::epsilon() *
+                        std::abs(lu_store_.diagonal(0))) {
+                throw std::domain_error(
+                    "Circulant band matrix is not symmetric.");
+            }
+        }
+
+        // With w = z + 1/z, c(z) is a polynomial of w of degree b, since
+        // P_k(w) = z^k + z^{-k} satisfies P_{k+1} = w P_k - P_{k-1}.
+        std::vector<val_type> q{lu_store_.diagonal(0)};
+        {
+            std::vector<val_type> p_prev{2}, p_cur{0, 1};
+            for (size_type k = 1; k <= b; ++k) {
+                q.resize(k + 1);
+                const auto kd = static_cast<std::ptrdiff_t>(k);
+                const val_type c =
+                    (lu_store_.diagonal(kd) + lu_store_.diagonal(-kd)) / 2;
+                for (size_type i = 0; i <= k; ++i) { q[i] += c * p_cur[i]; }
+                std::vector<val_type> p_next(k + 2);
+                for (size_type i = 0; i <= k; ++i) {
+                    p_next[i + 1] += p_cur[i];
+                    if (i < p_prev.size()) { p_next[i] -= p_prev[i]; }
+                }
+                p_prev = std::move(p_cur);
+                p_cur = std::move(p_next);
+            }
+        }
+
+        // Roots of q are assumed to be real (true for B-spline). Newton
+        // iteration starting at the left of all roots converges to the
+        // leftmost one monotonically, then it is deflated.
+        val_type bound{};
+        for (size_type i = 0; i < b; ++i) {
+            bound = std::max(bound, std::abs(q[i] / q[b]));
+        }
+        bound += 1;
+        poles_.clear();
+        init_len_.clear();
+        gain_ = q[b];
+        std::vector<val_type> deflated = q;
+        for (size_type j = 0; j < b; ++j) {
+            // polish with the original polynomial
+            const val_type w = newton_(q, newton_(deflated, -bound));
+            if (std::abs(w) <= 2) {
+                throw std::domain_error(
+                    "Circulant band matrix is not diagonally dominant.");
+            }
+            // root of z + 1/z = w inside unit circle, as reciprocal of the
+            // other one to avoid cancellation
+            const val_type r =
+                1 / (w / 2 + std::copysign(std::sqrt(w * w / 4 - 1), w));
+            poles_.push_back(r);
+            gain_ *= -1 / r;
+            const auto len = std::ceil(
+                std::log(std::numeric_limits<val_type>::epsilon()) /
+                std::log(std::abs(r)));
+            init_len_.push_back(std::min(
+                n, static_cast<size_type>(std::max(len, val_type{})) + 1));
+
+            // deflation
+            std::vector<val_type> quotient(deflated.size() - 1);
+            val_type carry{};
+            for (size_type i = deflated.size() - 1; i-- > 0;) {
+                carry = carry * w + deflated[i + 1];
+                quotient[i] = carry;
+            }
+            deflated = std::move(quotient);
+        }
+    }
+
+    template <typename Iter>
+    void solve_in_place_impl(Iter& iter) const {
+        const size_type n = lu_store_.dim();
+
+        using ind_type =
+            typename base_type::template ind_type_<util::remove_cvref_t<Iter>>;
+        const auto at = [&](size_type i) -> decltype(iter[ind_type{}]) {
+            return iter[static_cast<ind_type>(i)];
+        };
+
+        for (size_type j = 0; j < poles_.size(); ++j) {
+            const val_type r = poles_[j];
+            const val_type factor =
+                1 / (1 - std::pow(r, static_cast<val_type>(n)));
+
+            // causal recursion, y_i = x_i + r y_{i-1}
+            val_type sum = at(0);
+            val_type rk = r;
+            for (size_type k = 1; k < init_len_[j]; ++k, rk *= r) {
+                sum += rk * at(n - k);
+            }
+            at(0) = sum * factor;
+            for (size_type i = 1; i < n; ++i) { at(i) += r * at(i - 1); }
+
+            // anti-causal recursion, z_i = y_i + r z_{i+1}
+            sum = at(n - 1);
+            rk = r;
+            for (size_type k = 1; k < init_len_[j]; ++k, rk *= r) {
+                sum += rk * at(k - 1);
+            }
+            at(n - 1) = sum * factor;
+            for (size_type i = n - 1; i > 0; --i) { at(i - 1) += r * at(i); }
+        }
+
+        for (size_type i = 0; i < n; ++i) { at(i) /= gain_; }
+    }
+
+    template <typename U>
+    void solve_block_in_place_impl(U* block,
+                                   size_type pitch,
+                                   size_type width) const {
+        const size_type n = lu_store_.dim();
+
+        // row_i += a * row_j, across all right hand sides
+        const auto accumulate = [&](size_type i, size_type j, val_type a) {
+            U* row_i = block + i * pitch;
+            const U* row_j = block + j * pitch;
+            for (size_type w = 0; w < width; ++w) { row_i[w] += a * row_j[w]; }
+        };
+        const auto scale = [&](size_type i, val_type a) {
+            U* row_i = block + i * pitch;
+            for (size_type w = 0; w < width; ++w) { row_i[w] *= a; }
+        };
+
+        for (size_type j = 0; j < poles_.size(); ++j) {
+            const val_type r = poles_[j];
+            const val_type factor =
+                1 / (1 - std::pow(r, static_cast<val_type>(n)));
+
+            // causal recursion, rows n - k are untouched while summing
+            val_type rk = r;
+            for (size_type k = 1; k < init_len_[j]; ++k, rk *= r) {
+                accumulate(0, n - k, rk);
+            }
+            scale(0, factor);
+            for (size_type i = 1; i < n; ++i) { accumulate(i, i - 1, r); }
+
+            // anti-causal recursion, rows k - 1 are not the last one
+            rk = r;
+            for (size_type k = 1; k < init_len_[j]; ++k, rk *= r) {
+                accumulate(n - 1, k - 1, rk);
+            }
+            scale(n - 1, factor);
+            for (size_type i = n - 1; i > 0; --i) { accumulate(i - 1, i, r); }
+        }
+
+        for (size_type i = 0; i < n; ++i) {
+            U* row_i = block + i * pitch;
+            for (size_type w = 0; w < width; ++w) { row_i[w] /= gain_; }
+        }
+    }
+
+    // Each cyclic recursion has norm sum_k |r|^k / |1 - r^n| <= 1 / (1 - |r|),
+    // attained for negative poles (e.g. B-spline) as n grows.
+    val_type inverse_norm_bound_impl() const {
+        val_type bound = 1 / std::abs(gain_);
+        for (auto r : poles_) {
+            bound /= (1 - std::abs(r)) * (1 - std::abs(r));
+        }
+        return bound;
+    }
+};
+
+template <typename>
+class RecursiveFilter;
+
+/**
+ * @brief Solver for band matrix that is symmetric Toeplitz except for a few
+ * rows near both ends, e.g. the coefficient matrix of aperiodic interpolation
+ * on uniform grid. The matrix is split as A = C + U V^T, where C is the
+ * circulant matrix sharing the stencil of the middle row and U V^T corrects
+ * the rows that differ. By Sherman-Morrison-Woodbury formula, solving A is
+ * solving C by recursive filtering (see BandLU<CirculantBandMatrix>) plus a
+ * small dense correction. Since C^{-1} U decays exponentially away from both
+ * ends, the correction only touches entries near the ends.
+ *
+ */
+template <typename T>
+class RecursiveFilter<BandMatrix<T>>
+    : public BandLUBase<RecursiveFilter, BandMatrix<T>> {
+   public:
+    using base_type = BandLUBase<intp::RecursiveFilter, BandMatrix<T>>;
+    using matrix_type = BandMatrix<T>;
+    using size_type = typename matrix_type::size_type;
+    using val_type = typename matrix_type::val_type;
+
+    RecursiveFilter() = default;
+
+    // Filter coefficients are stored in members of this class, so they can
+    // not be computed in base class constructor.
+    template <typename Mat_>
+    RecursiveFilter(Mat_&& mat) {
+        this->compute(std::forward<Mat_>(mat));
+    }
+
+    /**
+     * @brief Number of rows differing from the circulant matrix, i.e. the rank
+     * of correction.
+     *
+     */
+    size_type correction_rank() const { return rows_.size(); }
+
+   private:
+    friend base_type;
+    using base_type::lu_store_;
+
+    BandLU<CirculantBandMatrix<val_type>> circulant_solver_;
+    // rows of A that differ from C
+    std::vector<size_type> rows_;
+    // non-zero elements of A - C in those rows, as (column, value) pairs
+    std::vector<std::vector<std::pair<size_type, val_type>>> diffs_;
+    // indices where C^{-1} U is not negligible
+    std::vector<size_type> window_;
+    // C^{-1} U restricted to window, row major
+    std::vector<val_type> z_;
+    // inverse of capacitance matrix I + V^T C^{-1} U, row major
+    std::vector<val_type> cap_inv_;
+
+    void compute_impl() {
+        const size_type n = lu_store_.dim();
+        const size_type p = lu_store_.lower_band_width();
+        const size_type q = lu_store_.upper_band_width();
+
+        // stencil of middle row, elements differ less than tol are
+        // considered equal
+        const size_type mid = n / 2;
+        const val_type tol = 64 * std::numeric_limits<val_type>::epsilon() *
+                             std::abs(lu_store_(mid, mid));
+        size_type b = 0;
+        for (size_type k = 1; k <= std::min(p, q) && k <= mid && mid + k < n;
+             ++k) {
+            if (std::abs(lu_store_(mid, mid - k) - lu_store_(mid, mid + k)) >
+                tol) {
+                throw std::domain_error(
+                    "Band matrix is not symmetric in the middle.");
+            }
+            if (lu_store_(mid, mid + k) != val_type{}) { b = k; }
+        }
+        if (n <= 2 * b) {
+            throw std::domain_error(
+                "Band matrix is too small for recursive filter.");
+        }
+        CirculantBandMatrix<val_type> circ_mat(n, b, b);
+        for (size_type j = mid - b; j <= mid + b; ++j) {
+            circ_mat(mid, j) = lu_store_(mid, j);
+        }
+        const auto c = [&](size_type i, size_type j) {
+            const size_type offset = (j + n - i) % n;
+            return offset <= b || offset + b >= n ? circ_mat(i, j)
+                                                  : val_type{};
+        };
+
+        // find rows differing from circulant matrix
+        rows_.clear();
+        diffs_.clear();
+        for (size_type i = 0; i < n; ++i) {
+            std::vector<std::pair<size_type, val_type>> diff;
+            const auto add_diff = [&](size_type j) {
+                const val_type a = j + p >= i && i + q >= j ? lu_store_(i, j)
+                                                            : val_type{};
+                if (std::abs(a - c(i, j)) > tol) {
+                    diff.emplace_back(j, a - c(i, j));
+                }
+            };
+            for (size_type j = i < p ? 0 : i - p; j < std::min(n, i + q + 1);
+                 ++j) {
+                add_diff(j);
+            }
+            // wrapped elements of circulant matrix, outside of band of A
+            for (size_type k = 1; k <= b; ++k) {
+                if (i < k) { add_diff(i + n - k); }
+                if (i + k >= n) { add_diff(i + k - n); }
+            }
+            if (!diff.empty()) {
+                rows_.push_back(i);
+                diffs_.push_back(std::move(diff));
+            }
+        }
+
+        circulant_solver_.compute(std::move(circ_mat));
+
+        // Z = C^{-1} U, with U consists of unit column vectors of rows_
+        const size_type m = rows_.size();
+        std::vector<std::vector<val_type>> z_full(m);
+        val_type z_max{};
+        for (size_type a = 0; a < m; ++a) {
+            z_full[a].assign(n, val_type{});
+            z_full[a][rows_[a]] = 1;
+            circulant_solver_.solve_in_place(z_full[a]);
+            for (auto v : z_full[a]) { z_max = std::max(z_max, std::abs(v)); }
+        }
+        window_.clear();
+        for (size_type i = 0; i < n; ++i) {
+            for (size_type a = 0; a < m; ++a) {
+                if (std::abs(z_full[a][i]) >
+                    std::numeric_limits<val_type>::epsilon() * z_max) {
+                    window_.push_back(i);
+                    break;
+                }
+            }
+        }
+        z_.resize(window_.size() * m);
+        for (size_type w = 0; w < window_.size(); ++w) {
+            for (size_type a = 0; a < m; ++a) {
+                z_[w * m + a] = z_full[a][window_[w]];
+            }
+        }
+
+        // capacitance matrix, inverted by Gauss-Jordan elimination with
+        // partial pivoting
+        std::vector<val_type> cap(m * m);
+        cap_inv_.assign(m * m, val_type{});
+        for (size_type a = 0; a < m; ++a) {
+            cap[a * m + a] = 1;
+            cap_inv_[a * m + a] = 1;
+            for (size_type c_ = 0; c_ < m; ++c_) {
+                for (auto& d : diffs_[a]) {
+                    cap[a * m + c_] += d.second * z_full[c_][d.first];
+                }
+            }
+        }
+        for (size_type k = 0; k < m; ++k) {
+            size_type piv = k;
+            for (size_type i = k + 1; i < m; ++i) {
+                if (std::abs(cap[i * m + k]) > std::abs(cap[piv * m + k])) {
+                    piv = i;
+                }
+            }
+            for (size_type j = 0; j < m; ++j) {
+                std::swap(cap[k * m + j], cap[piv * m + j]);
+                std::swap(cap_inv_[k * m + j], cap_inv_[piv * m + j]);
+            }
+            const val_type pivot = cap[k * m + k];
+            for (size_type j = 0; j < m; ++j) {
+                cap[k * m + j] /= pivot;
+                cap_inv_[k * m + j] /= pivot;
+            }
+            for (size_type i = 0; i < m; ++i) {
+                if (i == k) { continue; }
+                const val_type f = cap[i * m + k];
+                for (size_type j = 0; j < m; ++j) {
+                    cap[i * m + j] -= f * cap[k * m + j];
+                    cap_inv_[i * m + j] -= f * cap_inv_[k * m + j];
+                }
+            }
+        }
+    }
+
+    template <typename Iter>
+    void solve_in_place_impl(Iter& iter) const {
+        using ind_type =
+            typename base_type::template ind_type_<util::remove_cvref_t<Iter>>;
+        const auto at = [&](size_type i) -> decltype(iter[ind_type{}]) {
+            return iter[static_cast<ind_type>(i)];
+        };
+
+        circulant_solver_.solve_in_place(iter);
+
+        const size_type m = rows_.size();
+        if (m == 0) { return; }
+        thread_local std::vector<val_type> scratch;
+        scratch.assign(2 * m, val_type{});
+        val_type* g = scratch.data();
+        val_type* h = g + m;
+        for (size_type a = 0; a < m; ++a) {
+            for (auto& d : diffs_[a]) { g[a] += d.second * at(d.first); }
+        }
+        for (size_type a = 0; a < m; ++a) {
+            for (size_type c = 0; c < m; ++c) {
+                h[a] += cap_inv_[a * m + c] * g[c];
+            }
+        }
+        for (size_type w = 0; w < window_.size(); ++w) {
+            val_type v{};
+            for (size_type a = 0; a < m; ++a) { v += z_[w * m + a] * h[a]; }
+            at(window_[w]) -= v;
+        }
+    }
+
+    template <typename U>
+    void solve_block_in_place_impl(U* block,
+                                   size_type pitch,
+                                   size_type width) const {
+        circulant_solver_.solve_block_in_place(block, pitch, width);
+
+        const size_type m = rows_.size();
+        if (m == 0) { return; }
+        // g and h of all right hand sides, the a-th row holding g_a (h_a)
+        thread_local std::vector<U> scratch;
+        scratch.assign(2 * m * width, U{});
+        U* g = scratch.data();
+        U* h = g + m * width;
+        for (size_type a = 0; a < m; ++a) {
+            U* g_a = g + a * width;
+            for (auto& d : diffs_[a]) {
+                const U* row = block + d.first * pitch;
+                for (size_type w = 0; w < width; ++w) {
+                    g_a[w] += d.second * row[w];
+                }
+            }
+        }
+        for (size_type a = 0; a < m; ++a) {
+            U* h_a = h + a * width;
+            for (size_type c = 0; c < m; ++c) {
+                const val_type coef = cap_inv_[a * m + c];
+                const U* g_c = g + c * width;
+                for (size_type w = 0; w < width; ++w) {
+                    h_a[w] += coef * g_c[w];
+                }
+            }
+        }
+        for (size_type i = 0; i < window_.size(); ++i) {
+            U* row = block + window_[i] * pitch;
+            for (size_type a = 0; a < m; ++a) {
+                const val_type coef = z_[i * m + a];
+                const U* h_a = h + a * width;
+                for (size_type w = 0; w < width; ++w) {
+                    row[w] -= coef * h_a[w];
+                }
+            }
+        }
+    }
+
+    // A^{-1} = (I - Z K V^T) C^{-1} with K the inverse capacitance matrix, and
+    // row sums of |Z K V^T| are bounded by |Z K| times row sums of |V^T|.
+    val_type inverse_norm_bound_impl() const {
+        const size_type m = rows_.size();
+        std::vector<val_type> diff_norm(m);
+        for (size_type a = 0; a < m; ++a) {
+            for (auto& d : diffs_[a]) { diff_norm[a] += std::abs(d.second); }
+        }
+        val_type correction{};
+        for (size_type w = 0; w < window_.size(); ++w) {
+            val_type row_sum{};
+            for (size_type a = 0; a < m; ++a) {
+                val_type zk{};
+                for (size_type c = 0; c < m; ++c) {
+                    zk += z_[w * m + c] * cap_inv_[c * m + a];
+                }
+                row_sum += std::abs(zk) * diff_norm[a];
+            }
+            correction = std::max(correction, row_sum);
+        }
+        return (1 + correction) * circulant_solver_.inverse_norm_bound();
+    }
 };
 
 }  // namespace intp
@@ -67,9 +67,9 @@ class BandMatrix {
     util::remove_cvref_t<Iter> operator*(const Iter& x) const {
         util::remove_cvref_t<Iter> xx(x.size());
         for (size_type i = 0; i < x.size(); ++i) {
-            for (size_type j = p_ > i ? p_ - i : 0, k = i > p_ ? i - p_ : 0;
-                 j < std::min(p_ + q_ + 1, n_ + p_ - i); ++j, ++k) {
-                xx[i] += bands_(i, j) * x[k];
+            for (size_type j = i > p_ ? i - p_ : 0;
+                 j < std::min(i + q_ + 1, n_); ++j) {
+                xx[i] += (*this)(i, j) * x[j];
             }
         }
         return xx;
@@ -178,6 +178,88 @@ class ExtendedBandMatrix : public BandMatrix<T> {
     using base_type::q_;
 };
 
+/**
+ * @brief Circulant band matrix, each row of which is the previous row rotated
+ * right by one element. A_{i,j} = c_{(j-i) mod n}, where only c_{-p}, ...,
+ * c_{q} are non-zero, thus the whole matrix is stored in one row of band.
+ *
+ * @tparam T value type of matrix element
+ */
+template <typename T>
+class CirculantBandMatrix {
+   public:
+    using size_type = size_t;
+    using val_type = T;
+
+    // Create a zero circulant band matrix with given dimension, lower and
+    // upper bandwidth. Dimension should be larger than total band width.
+    CirculantBandMatrix(size_type n, size_type p, size_type q)
+        : n_(n), p_(p), q_(q), band_(1 + p_ + q_) {}
+
+    CirculantBandMatrix() : CirculantBandMatrix(1, 0, 0) {}
+
+    // properties
+
+    size_type dim() const noexcept { return n_; }
+
+    size_type lower_band_width() const noexcept { return p_; }
+
+    size_type upper_band_width() const noexcept { return q_; }
+
+    /**
+     * @brief Element on the k-th diagonal, k ranges from -p to q.
+     *
+     */
+    val_type diagonal(std::ptrdiff_t k) const {
+        return band_[static_cast<size_type>(static_cast<std::ptrdiff_t>(p_) +
+                                            k)];
+    }
+
+    /**
+     * @brief Return read/write reference to matrix element, indices are
+     * zero-based. Elements on the same (cyclic) diagonal share one storage.
+     *
+     * @param i row index
+     * @param j column index
+     * @return val_type&
+     */
+    val_type& operator()(size_type i, size_type j) {
+        return band_[band_index_(i, j)];
+    }
+
+    val_type operator()(size_type i, size_type j) const {
+        return band_[band_index_(i, j)];
+    }
+
+    /**
+     * @brief Matrix-Vector multiplication
+     *
+     * @param x vector to be multiplied
+     */
+    template <typename Iter>
+    util::remove_cvref_t<Iter> operator*(const Iter& x) const {
+        util::remove_cvref_t<Iter> xx(x.size());
+        for (size_type i = 0; i < n_; ++i) {
+            for (size_type k = 0; k < band_.size(); ++k) {
+                xx[i] += band_[k] * x[(i + n_ + k - p_) % n_];
+            }
+        }
+        return xx;
+    }
+
+   private:
+    size_type n_;
+    size_type p_, q_;
+    std::vector<val_type> band_;
+
+    size_type band_index_(size_type i, size_type j) const {
+        const size_type offset = (j + n_ - i) % n_;
+        CUSTOM_ASSERT(offset <= q_ || offset + p_ >= n_,
+                      "Given i and j not in circulant bands.");
+        return offset <= q_ ? p_ + offset : p_ + offset - n_;
+    }
+};
+
 }  // namespace intp
 
 #endif
@@ -0,0 +1,528 @@
+#ifndef INTP_CHUNKED_MESH
+#define INTP_CHUNKED_MESH
+
+#include <algorithm>  // min
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>  // current_exception
+#include <fstream>
+#include <functional>  // ref
+#include <future>  // promise, shared_future
+#include <list>
+#include <memory>  // shared_ptr
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Mesh.hpp"
+
+namespace intp {
+
+/**
+ * @brief A read-only multi dimension mesh stored on disk in cubic bricks.
+ * Bricks are loaded when first accessed and kept in a bounded LRU cache, so
+ * that only the touched region of a huge mesh resides in memory. It can serve
+ * as control point container of BSpline for evaluation, i.e.
+ * `BSpline<T, D, ChunkedMesh<T, D>>`.
+ *
+ * Concurrent reads are thread-safe. Copies share the same file and cache.
+ *
+ * The file starts with a header of 64-bit unsigned integers: a magic number,
+ * sizeof(T), D, brick extent and the D dimension sizes. Bricks follow in
+ * row-major order of brick indices, each holding extent^D values in row-major
+ * order, padded with zeros beyond the mesh boundary.
+ *
+ * @tparam T Type of data stored
+ * @tparam D Dimension
+ */
+template <typename T, size_t D>
+class ChunkedMesh {
+   public:
+    using size_type = size_t;
+    using val_type = T;
+    const static size_type dim = D;
+    using index_type = typename MeshDimension<dim>::index_type;
+
+   private:
+    using Brick = std::vector<val_type>;
+
+    static constexpr std::uint64_t magic_ = 0x4b524250544e49;  // "INTPBRK"
+    static constexpr size_type header_size_ = 4 + dim;
+
+    struct CacheEntry {
+        std::shared_ptr<const Brick> brick;
+        std::list<size_type>::iterator lru_pos;
+    };
+
+    /**
+     * @brief A brick being read, whose readers other than the one reading it
+     * wait for the future.
+     *
+     */
+    struct Pending {
+        std::promise<std::shared_ptr<const Brick>> promise;
+        std::shared_future<std::shared_ptr<const Brick>> future;
+    };
+
+    /**
+     * @brief File and cache shared by copies
+     *
+     */
+    struct Storage {
+        std::string path;
+        std::mutex mutex;
+        // brick indices, most recently used at front
+        std::list<size_type> lru;
+        std::unordered_map<size_type, CacheEntry> cache;
+        // bricks being read, on cache miss or by prefetching
+        std::unordered_map<size_type, Pending> pending;
+        // prefetched bricks waiting for a reader thread
+        std::deque<size_type> requests;
+        std::condition_variable requested;
+        // reader threads, started on first prefetch
+        std::vector<std::thread> readers;
+        bool stop = false;
+        size_type capacity;
+        size_type loads = 0;
+        // distinguishes storages in thread local lookup
+        std::uint64_t serial;
+
+        Storage() = default;
+        Storage(const Storage&) = delete;
+        Storage& operator=(const Storage&) = delete;
+
+        /**
+         * @brief Join reader threads, dropping prefetches not started.
+         *
+         */
+        ~Storage() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+            requested.notify_all();
+            for (auto& r : readers) { r.join(); }
+        }
+    };
+
+    // maximum number of bricks read in background at the same time
+    static constexpr size_type max_pending_ = 4;
+    // number of reader threads serving prefetches of a storage
+    static constexpr size_type reader_num_ = 2;
+
+    MeshDimension<dim> dimension_;
+    // number of bricks in each dimension
+    MeshDimension<dim> brick_grid_;
+    size_type extent_;
+    size_type brick_size_;
+
+    std::shared_ptr<Storage> storage_;
+
+    static std::uint64_t next_serial_() {
+        static std::atomic<std::uint64_t> serial{0};
+        return ++serial;
+    }
+
+    static MeshDimension<dim> brick_grid_of_(const MeshDimension<dim>& dims,
+                                             size_type extent) {
+        index_type sizes;
+        for (size_type d = 0; d < dim; ++d) {
+            sizes[d] = (dims.dim_size(d) + extent - 1) / extent;
+        }
+        MeshDimension<dim> grid;
+        grid.resize(sizes);
+        return grid;
+    }
+
+    struct LastBrick {
+        std::uint64_t serial = 0;
+        size_type brick_ind = 0;
+        std::shared_ptr<const Brick> brick;
+    };
+
+    /**
+     * @brief The brick last used by calling thread
+     *
+     */
+    static LastBrick& last_brick_() {
+        thread_local LastBrick last;
+        return last;
+    }
+
+    struct ThreadFile {
+        std::uint64_t serial = 0;
+        std::ifstream file;
+    };
+
+    /**
+     * @brief File stream of calling thread, so that bricks are read without
+     * holding the mutex. It is reopened when another storage is read.
+     *
+     */
+    static std::ifstream& thread_file_(const Storage& s) {
+        thread_local ThreadFile tf;
+        if (tf.serial != s.serial) {
+            tf.file = std::ifstream(s.path, std::ios::binary);
+            tf.serial = s.serial;
+        }
+        return tf.file;
+    }
+
+    size_type brick_index_(const index_type& indices) const {
+        size_type brick_ind{};
+        for (size_type d = 0; d < dim; ++d) {
+            brick_ind =
+                brick_ind * brick_grid_.dim_size(d) + indices[d] / extent_;
+        }
+        return brick_ind;
+    }
+
+    static std::shared_ptr<const Brick> read_brick_(std::istream& is,
+                                                    size_type brick_ind,
+                                                    size_type brick_size) {
+        auto brick = std::make_shared<Brick>(brick_size);
+        // recover from a failed read before
+        is.clear();
+        is.seekg(static_cast<std::streamoff>(
+            header_size_ * sizeof(std::uint64_t) +
+            brick_ind * brick_size * sizeof(val_type)));
+        is.read(reinterpret_cast<char*>(brick->data()),
+                static_cast<std::streamsize>(brick_size * sizeof(val_type)));
+        if (!is) {
+            throw std::runtime_error("Failed to read brick from file.");
+        }
+        return brick;
+    }
+
+    /**
+     * @brief Put a brick into cache as the most recently used one, evicting
+     * the least recently used ones beyond capacity. Evicted bricks still in
+     * use by other threads are released when those threads move on. The
+     * mutex should be held by caller.
+     *
+     * @return the cached brick, which may be an equal one cached before
+     */
+    static std::shared_ptr<const Brick> cache_brick_(
+        Storage& s,
+        size_type brick_ind,
+        std::shared_ptr<const Brick> brick) {
+        auto it = s.cache.find(brick_ind);
+        if (it != s.cache.end()) {
+            s.lru.splice(s.lru.begin(), s.lru, it->second.lru_pos);
+            return it->second.brick;
+        }
+        s.lru.push_front(brick_ind);
+        s.cache.emplace(brick_ind, CacheEntry{brick, s.lru.begin()});
+        while (s.cache.size() > s.capacity) {
+            s.cache.erase(s.lru.back());
+            s.lru.pop_back();
+        }
+        return brick;
+    }
+
+    /**
+     * @brief Finish reading a brick, caching it and fulfilling its promise,
+     * or passing the exception to those waiting for it. The mutex should be
+     * held by caller.
+     *
+     */
+    static std::shared_ptr<const Brick> complete_(
+        Storage& s,
+        size_type brick_ind,
+        std::shared_ptr<const Brick> brick,
+        std::exception_ptr error) {
+        auto it = s.pending.find(brick_ind);
+        auto promise = std::move(it->second.promise);
+        s.pending.erase(it);
+        if (error) {
+            promise.set_exception(error);
+            return nullptr;
+        }
+        ++s.loads;
+        brick = cache_brick_(s, brick_ind, std::move(brick));
+        promise.set_value(brick);
+        return brick;
+    }
+
+    /**
+     * @brief Body of reader thread, reading prefetched bricks in order of
+     * request until the storage is destroyed.
+     *
+     */
+    static void read_ahead_(Storage& s, size_type brick_size) {
+        std::ifstream file(s.path, std::ios::binary);
+        for (;;) {
+            size_type brick_ind;
+            {
+                std::unique_lock<std::mutex> lock(s.mutex);
+                s.requested.wait(
+                    lock, [&s] { return s.stop || !s.requests.empty(); });
+                if (s.stop) { return; }
+                brick_ind = s.requests.front();
+                s.requests.pop_front();
+            }
+            std::shared_ptr<const Brick> brick;
+            std::exception_ptr error;
+            try {
+                brick = read_brick_(file, brick_ind, brick_size);
+            } catch (...) { error = std::current_exception(); }
+            std::lock_guard<std::mutex> lock(s.mutex);
+            complete_(s, brick_ind, std::move(brick), error);
+        }
+    }
+
+    /**
+     * @brief Get a brick, from the last one used by calling thread, or the
+     * cache, or a pending prefetch, or the file, in that order.
+     *
+     */
+    const Brick& brick_(size_type brick_ind) const {
+        auto& last = last_brick_();
+        if (last.serial == storage_->serial && last.brick_ind == brick_ind) {
+            return *last.brick;
+        }
+
+        auto& s = *storage_;
+        std::unique_lock<std::mutex> lock(s.mutex);
+        std::shared_ptr<const Brick> brick;
+        auto pending = s.pending.find(brick_ind);
+        if (s.cache.count(brick_ind) == 0 && pending != s.pending.end()) {
+            const auto future = pending->second.future;
+            lock.unlock();
+            brick = future.get();
+            lock.lock();
+        } else if (s.cache.count(brick_ind) == 0) {
+            // The file is read without holding the mutex, so that other
+            // threads are not stalled. Those missing the same brick meanwhile
+            // wait for it as a pending one.
+            auto& p = s.pending[brick_ind];
+            p.future = p.promise.get_future().share();
+            lock.unlock();
+            std::exception_ptr error;
+            try {
+                brick = read_brick_(thread_file_(s), brick_ind, brick_size_);
+            } catch (...) { error = std::current_exception(); }
+            lock.lock();
+            brick = complete_(s, brick_ind, std::move(brick), error);
+            if (error) { std::rethrow_exception(error); }
+        }
+        brick = cache_brick_(s, brick_ind, std::move(brick));
+
+        last.serial = s.serial;
+        last.brick_ind = brick_ind;
+        last.brick = std::move(brick);
+        return *last.brick;
+    }
+
+    /**
+     * @brief Write the bricks covering a slab of hyperplanes, i.e. a mesh
+     * whose first dimension is a range of that of the whole mesh, starting
+     * from a multiple of extent.
+     *
+     */
+    static void write_slab_(std::ostream& os,
+                            const Mesh<val_type, dim>& slab,
+                            size_type extent) {
+        const auto grid = brick_grid_of_(slab.dimension(), extent);
+        index_type local_sizes;
+        local_sizes.fill(extent);
+        MeshDimension<dim> local_dimension;
+        local_dimension.resize(local_sizes);
+
+        Brick brick(local_dimension.size());
+        for (size_type b = 0; b < grid.size(); ++b) {
+            const auto brick_ind = grid.dimwise_indices(b);
+            for (size_type i = 0; i < brick.size(); ++i) {
+                auto ind = local_dimension.dimwise_indices(i);
+                bool inside = true;
+                for (size_type d = 0; d < dim; ++d) {
+                    ind[d] += brick_ind[d] * extent;
+                    inside = inside && ind[d] < slab.dim_size(d);
+                }
+                brick[i] = inside ? slab(ind) : val_type{};
+            }
+            os.write(reinterpret_cast<const char*>(brick.data()),
+                     static_cast<std::streamsize>(brick.size() *
+                                                  sizeof(val_type)));
+        }
+    }
+
+    static std::ofstream open_for_write_(const MeshDimension<dim>& dims,
+                                         size_type extent,
+                                         const std::string& path) {
+        if (extent == 0) {
+            throw std::domain_error("Brick extent should be positive.");
+        }
+        std::ofstream os(path, std::ios::binary | std::ios::trunc);
+        std::array<std::uint64_t, header_size_> header{
+            magic_, sizeof(val_type), dim, static_cast<std::uint64_t>(extent)};
+        for (size_type d = 0; d < dim; ++d) {
+            header[4 + d] = static_cast<std::uint64_t>(dims.dim_size(d));
+        }
+        os.write(reinterpret_cast<const char*>(header.data()),
+                 sizeof(header));
+        return os;
+    }
+
+   public:
+    /**
+     * @brief Open a brick file.
+     *
+     * @param path path of brick file
+     * @param cache_bricks maximum number of bricks held in memory
+     */
+    ChunkedMesh(const std::string& path, size_type cache_bricks)
+        : storage_(std::make_shared<Storage>()) {
+        auto& s = *storage_;
+        s.path = path;
+        std::ifstream file(path, std::ios::binary);
+        std::array<std::uint64_t, header_size_> header{};
+        file.read(reinterpret_cast<char*>(header.data()), sizeof(header));
+        if (!file || header[0] != magic_ || header[1] != sizeof(val_type) ||
+            header[2] != dim || header[3] == 0) {
+            throw std::runtime_error(
+                "File is not a brick file of matching type and dimension.");
+        }
+        index_type sizes;
+        for (size_type d = 0; d < dim; ++d) {
+            sizes[d] = static_cast<size_type>(header[4 + d]);
+        }
+        dimension_.resize(sizes);
+        extent_ = static_cast<size_type>(header[3]);
+        brick_grid_ = brick_grid_of_(dimension_, extent_);
+        brick_size_ = util::pow(extent_, dim);
+        s.capacity = std::max(cache_bricks, size_type{1});
+        s.serial = next_serial_();
+    }
+
+    /**
+     * @brief Write a mesh into a brick file.
+     *
+     */
+    static void write(const Mesh<val_type, dim>& mesh,
+                      size_type extent,
+                      const std::string& path) {
+        auto os = open_for_write_(mesh.dimension(), extent, path);
+        write_slab_(os, mesh, extent);
+        if (!os) { throw std::runtime_error("Failed to write brick file."); }
+    }
+
+    /**
+     * @brief Convert a raw binary file of values in row-major order (e.g.
+     * control points written by out-of-core fitting) into a brick file, with
+     * extent hyperplanes in memory at a time.
+     *
+     */
+    static void write(const std::string& raw_file,
+                      const MeshDimension<dim>& dimension,
+                      size_type extent,
+                      const std::string& path) {
+        std::ifstream is(raw_file, std::ios::binary);
+        if (!is) { throw std::runtime_error("Cannot open raw file."); }
+        auto os = open_for_write_(dimension, extent, path);
+
+        index_type slab_sizes;
+        for (size_type d = 0; d < dim; ++d) {
+            slab_sizes[d] = dimension.dim_size(d);
+        }
+        for (size_type p0 = 0; p0 < dimension.dim_size(0); p0 += extent) {
+            slab_sizes[0] = std::min(extent, dimension.dim_size(0) - p0);
+            MeshDimension<dim> slab_dimension;
+            slab_dimension.resize(slab_sizes);
+            Mesh<val_type, dim> slab{slab_dimension};
+            is.read(reinterpret_cast<char*>(slab.data()),
+                    static_cast<std::streamsize>(slab.size() *
+                                                 sizeof(val_type)));
+            if (!is) {
+                throw std::runtime_error(
+                    "Size of raw file mismatches mesh dimension.");
+            }
+            write_slab_(os, slab, extent);
+        }
+        if (!os) { throw std::runtime_error("Failed to write brick file."); }
+    }
+
+    // properties
+
+    size_type size() const { return dimension_.size(); }
+
+    size_type dim_size(size_type dim_ind) const {
+        return dimension_.dim_size(dim_ind);
+    }
+
+    const MeshDimension<dim>& dimension() const { return dimension_; }
+
+    size_type brick_extent() const { return extent_; }
+
+    size_type cache_capacity() const { return storage_->capacity; }
+
+    /**
+     * @brief Number of bricks read from file so far, including those read
+     * again after eviction.
+     *
+     */
+    size_type brick_loads() const {
+        std::lock_guard<std::mutex> lock(storage_->mutex);
+        return storage_->loads;
+    }
+
+    // element access
+
+    val_type operator()(const index_type& indices) const {
+        size_type local_ind{};
+        for (size_type d = 0; d < dim; ++d) {
+            local_ind = local_ind * extent_ + indices[d] % extent_;
+        }
+        return brick_(brick_index_(indices))[local_ind];
+    }
+
+    /**
+     * @brief Start reading the brick containing given element in background,
+     * unless it is already cached or being read, or too many bricks are being
+     * read. Access to the brick afterwards waits for the reading to finish
+     * instead of reading it again. Bricks are read by a few reader threads
+     * owned by the storage, which are joined when the last copy is destroyed.
+     *
+     */
+    void prefetch(const index_type& indices) const {
+        const size_type brick_ind = brick_index_(indices);
+        const auto& last = last_brick_();
+        if (last.serial == storage_->serial && last.brick_ind == brick_ind) {
+            return;
+        }
+
+        auto& s = *storage_;
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (s.cache.count(brick_ind) != 0 || s.pending.count(brick_ind) != 0 ||
+            s.pending.size() >= max_pending_) {
+            return;
+        }
+        if (s.readers.empty()) {
+            for (size_type i = 0; i < reader_num_; ++i) {
+                s.readers.emplace_back(&ChunkedMesh::read_ahead_, std::ref(s),
+                                       brick_size_);
+            }
+        }
+        auto& p = s.pending[brick_ind];
+        p.future = p.promise.get_future().share();
+        s.requests.push_back(brick_ind);
+        s.requested.notify_one();
+    }
+
+    template <typename... Indices>
+    val_type operator()(Indices... indices) const {
+        static_assert(sizeof...(Indices) == dim,
+                      "Number of indices mismatches dimension.");
+        return operator()(index_type{static_cast<size_type>(indices)...});
+    }
+};
+
+}  // namespace intp
+
+#endif
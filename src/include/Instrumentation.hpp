@@ -0,0 +1,136 @@
+#ifndef INTP_INSTRUMENTATION
+#define INTP_INSTRUMENTATION
+
+#include <cstdint>
+
+#ifdef INTP_ENABLE_INSTRUMENTATION
+#include <chrono>
+#endif
+
+namespace intp {
+
+namespace instrument {
+
+/**
+ * @brief Whether instrumentation is compiled in. Define macro
+ * `INTP_ENABLE_INSTRUMENTATION` before including any header of this library
+ * (or turn on CMake option `BSPLINE_INTERP_INSTRUMENTATION`) to enable it.
+ *
+ */
+#ifdef INTP_ENABLE_INSTRUMENTATION
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+/**
+ * @brief Counters and timers of hot paths. Each thread has its own copy, so
+ * updating them needs no synchronization.
+ *
+ */
+struct Counters {
+    // knot lookup in `BSpline::get_knot_iter`
+    std::uint64_t knot_hint_hit = 0;
+    std::uint64_t knot_hint_miss = 0;
+    // estimated comparisons of binary searches after hint misses, i.e. the
+    // upper bound of each search given the length of the searched range
+    std::uint64_t binary_search_steps = 0;
+    // coordinates out of range of aperiodic dimension, which are clamped to
+    // the boundary segment (i.e. extrapolated)
+    std::uint64_t out_of_range = 0;
+
+    // spline evaluations
+    std::uint64_t evaluations = 0;
+    std::uint64_t derivative_evaluations = 0;
+
+    // fitting phases, time in nanoseconds
+    std::uint64_t solver_builds = 0;
+    std::uint64_t solver_build_ns = 0;
+    // coefficient matrices of a dimension found in factorization cache
+    std::uint64_t solver_cache_hits = 0;
+    std::uint64_t solves = 0;
+    std::uint64_t solve_ns = 0;
+};
+
+/**
+ * @brief Counters of calling thread. When instrumentation is disabled they
+ * stay zero.
+ *
+ */
+inline Counters& counters() {
+#ifdef INTP_ENABLE_INSTRUMENTATION
+    thread_local Counters c;
+#else
+    static Counters c;
+#endif
+    return c;
+}
+
+/**
+ * @brief Reset counters of calling thread to zero.
+ *
+ */
+inline void reset() {
+    counters() = Counters{};
+}
+
+#ifdef INTP_ENABLE_INSTRUMENTATION
+/**
+ * @brief Add elapsed time since construction to a timer counter on
+ * destruction, and increase the corresponding call counter by one.
+ *
+ */
+class ScopedTimer {
+   public:
+    ScopedTimer(std::uint64_t Counters::*calls, std::uint64_t Counters::*ns)
+        : calls_(calls), ns_(ns), start_(std::chrono::steady_clock::now()) {}
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+    ~ScopedTimer() {
+        auto& c = counters();
+        ++(c.*calls_);
+        c.*ns_ += static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_)
+                .count());
+    }
+
+   private:
+    std::uint64_t Counters::*calls_;
+    std::uint64_t Counters::*ns_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * @brief Upper bound of number of comparisons made by binary search in a
+ * range of length n.
+ *
+ */
+inline std::uint64_t bisection_steps(std::uint64_t n) {
+    std::uint64_t s = 0;
+    for (; n > 0; n >>= 1) { ++s; }
+    return s;
+}
+#endif
+
+}  // namespace instrument
+
+}  // namespace intp
+
+// Macros used in hot paths, expanding to nothing when instrumentation is
+// disabled.
+#ifdef INTP_ENABLE_INSTRUMENTATION
+#define INTP_COUNT(field) ++::intp::instrument::counters().field
+#define INTP_COUNT_ADD(field, n) ::intp::instrument::counters().field += (n)
+#define INTP_TIME_SCOPE(calls, ns)                             \
+    const ::intp::instrument::ScopedTimer intp_scoped_timer_ { \
+        &::intp::instrument::Counters::calls,                  \
+            &::intp::instrument::Counters::ns                  \
+    }
+#else
+#define INTP_COUNT(field) static_cast<void>(0)
+#define INTP_COUNT_ADD(field, n) static_cast<void>(0)
+#define INTP_TIME_SCOPE(calls, ns) static_cast<void>(0)
+#endif
+
+#endif
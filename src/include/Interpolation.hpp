@@ -1,15 +1,17 @@
 #ifndef INTP_INTERPOLATION
 #define INTP_INTERPOLATION
 
-#include <cmath>  // ceil
+#include <cmath>  // floor
 #include <initializer_list>
 
 #include "InterpolationTemplate.hpp"
+#include "PiecewisePolynomial.hpp"
+#include "SplineCollection.hpp"
 
 namespace intp {
 
 template <typename T, size_t D>
-class InterpolationFunction {  // TODO: Add integration
+class InterpolationFunction {
    public:
     using val_type = T;
     using spline_type = BSpline<T, D>;
@@ -32,23 +34,37 @@ class InterpolationFunction {  // TODO: Add integration
 
     friend class InterpolationFunctionTemplate<T, D>;
 
+    template <typename, size_t>
+    friend class InterpolationFunction;
+
+    // for sharing grid among functions
+    template <typename, size_t>
+    friend class SplineCollection;
+
     // auxiliary methods
 
+    /**
+     * @brief Guess index of the knot at the lower end of the segment where
+     * coordinate locates. Knots in the interior of uniform dimension are
+     * evenly spaced, thus the guess is exact there.
+     *
+     */
+    inline size_type knot_hint_(size_type dim_ind, coord_type x) const {
+        const size_type o = spline_.dim_order(dim_ind);
+        if (!uniform_[dim_ind]) { return o; }
+        const coord_type first_inner_knot = *(
+            spline_.knots_begin(dim_ind) +
+            static_cast<typename spline_type::diff_type>(o + 1));
+        const coord_type seg =
+            std::floor((x - first_inner_knot) / dx_[dim_ind]) + 1;
+        return std::min(spline_.knots_num(dim_ind) - o - 2,
+                        o + static_cast<size_type>(std::max(0., seg)));
+    }
+
     template <size_type... di>
     inline val_type call_op_helper(util::index_sequence<di...>,
                                    DimArray<coord_type> c) const {
-        return spline_(std::make_pair(
-            c[di],
-            uniform_[di]
-                ? std::min(spline_.knots_num(di) - order - 2,
-                           static_cast<size_type>(std::ceil(std::max(
-                               0., (c[di] - range(di).first) / dx_[di] -
-                                       (periodicity_[di]
-                                            ? 1.
-                                            : .5 * static_cast<coord_type>(
-                                                       order + 1))))) +
-                               order)
-                : order)...);
+        return spline_(std::make_pair(c[di], knot_hint_(di, c[di]))...);
     }
 
     template <size_type... di>
@@ -57,16 +73,7 @@ class InterpolationFunction {  // TODO: Add integration
                                       DimArray<size_type> d) const {
         return spline_.derivative_at(std::make_tuple(
             static_cast<coord_type>(c[di]), static_cast<size_type>(d[di]),
-            uniform_[di]
-                ? std::min(spline_.knots_num(di) - order - 2,
-                           static_cast<size_type>(std::ceil(std::max(
-                               0., (c[di] - range(di).first) / dx_[di] -
-                                       (periodicity_[di]
-                                            ? 1.
-                                            : .5 * static_cast<coord_type>(
-                                                       order + 1))))) +
-                               order)
-                : order)...);
+            knot_hint_(di, c[di]))...);
     }
 
     // overload for uniform knots
@@ -218,6 +225,40 @@ class InterpolationFunction {  // TODO: Add integration
 #endif
     }
 
+    /**
+     * @brief Wrap a spline of one dimension lower, obtained by reducing the
+     * underlying spline along one dimension, into an interpolation function.
+     *
+     * @param dim_ind index of the reduced dimension
+     * @param reduced_spline the reduced spline
+     */
+    template <size_type D_ = dim>
+    typename std::enable_if<(D_ > 1),
+                            InterpolationFunction<val_type, D_ - 1>>::type
+    reduce_(size_type dim_ind, BSpline<val_type, D_ - 1> reduced_spline) const {
+        std::array<coord_type, D_ - 1> dx;
+        std::array<bool, D_ - 1> uniform;
+        for (size_type d = 0, rd = 0; d < dim; ++d) {
+            if (d == dim_ind) { continue; }
+            dx[rd] = dx_[d];
+            uniform[rd] = uniform_[d];
+            ++rd;
+        }
+        return InterpolationFunction<val_type, D_ - 1>(
+            std::move(reduced_spline), dx, uniform);
+    }
+
+    // constructor for function derived from another one, with spline given
+    InterpolationFunction(spline_type spline,
+                          DimArray<coord_type> dx,
+                          DimArray<bool> uniform)
+        : order(spline.order), spline_(std::move(spline)), dx_(dx) {
+        for (size_type d = 0; d < dim; ++d) {
+            periodicity_[d] = spline_.periodicity(d);
+        }
+        uniform_ = uniform;
+    }
+
     inline void boundary_check_(const DimArray<coord_type>& coord) const {
         for (size_type d = 0; d < dim; ++d) {
             if (!periodicity_[d] &&
@@ -303,6 +344,31 @@ class InterpolationFunction {  // TODO: Add integration
                           std::pair<Ts, Ts>... x_ranges)
         : InterpolationFunction(spline_order, {}, f_mesh, x_ranges...) {}
 
+    /**
+     * @brief Construct a new nD Interpolation Function object from data in
+     * external storage of any layout, which is read in place.
+     *
+     * @param spline_order order of interpolation
+     * @param periodicity an array describing periodicity of each dimension
+     * @param f_view a view of data to be interpolated
+     * @param x_ranges pairs of x_min and x_max or begin and end iterator
+     */
+    template <typename... Ts>
+    InterpolationFunction(size_type spline_order,
+                          DimArray<bool> periodicity,
+                          MeshView<const val_type, dim> f_view,
+                          std::pair<Ts, Ts>... x_ranges)
+        : InterpolationFunction(InterpolationFunctionTemplate<val_type, dim>{
+              spline_order, periodicity, f_view.dimension(), x_ranges...}
+                                    .interpolate(f_view)) {}
+
+    // Non-periodic for all dimension
+    template <typename... Ts>
+    InterpolationFunction(size_type spline_order,
+                          MeshView<const val_type, dim> f_view,
+                          std::pair<Ts, Ts>... x_ranges)
+        : InterpolationFunction(spline_order, {}, f_view, x_ranges...) {}
+
     // constructor for partial construction, that is, without interpolated
     // values
     template <typename... Ts>
@@ -343,6 +409,26 @@ class InterpolationFunction {  // TODO: Add integration
         return call_op_helper(util::make_index_sequence<dim>{}, coord);
     }
 
+    /**
+     * @brief Get spline values at a batch of points, pipelined with prefetch
+     * of control points. See BSpline::evaluate.
+     *
+     * @param first, last range of coordinate arrays
+     * @param d_first beginning of the destination range
+     * @param lookahead number of points looked up in advance
+     */
+    template <typename InputIter, typename OutputIter>
+    OutputIter evaluate(InputIter first,
+                        InputIter last,
+                        OutputIter d_first,
+                        size_type lookahead = 8) const {
+        return spline_.evaluate(
+            first, last, d_first, lookahead,
+            [this](size_type dim_ind, coord_type x) {
+                return knot_hint_(dim_ind, x);
+            });
+    }
+
     /**
      * @brief Get spline value, but with out of boundary check.
      *
@@ -441,6 +527,269 @@ class InterpolationFunction {  // TODO: Add integration
                 static_cast<size_type>(coord_deriOrder_pair.second)...});
     }
 
+    /**
+     * @brief Get definite integral over a box.
+     *
+     * @param box lower and upper limits of each dimension
+     */
+    val_type integrate(DimArray<std::pair<coord_type, coord_type>> box) const {
+        return spline_.integrate(box);
+    }
+
+    /**
+     * @brief Get definite integral over a box.
+     *
+     * @param x_ranges pairs of lower and upper limits of each dimension
+     */
+    template <typename... Ts,
+              typename = typename std::enable_if<sizeof...(Ts) == dim>::type>
+    val_type integrate(std::pair<Ts, Ts>... x_ranges) const {
+        return integrate(DimArray<std::pair<coord_type, coord_type>>{
+            static_cast<std::pair<coord_type, coord_type>>(x_ranges)...});
+    }
+
+    /**
+     * @brief Get definite integral over the whole interpolation range.
+     *
+     */
+    val_type integrate() const { return spline_.integrate(); }
+
+    /**
+     * @brief Get definite integral along one dimension, the result is an
+     * interpolation function of one dimension lower.
+     *
+     * @param dim_ind dimension index
+     * @param a lower limit
+     * @param b upper limit
+     */
+    template <size_type D_ = dim>
+    typename std::enable_if<(D_ > 1),
+                            InterpolationFunction<val_type, D_ - 1>>::type
+    integrate_along(size_type dim_ind, coord_type a, coord_type b) const {
+        return reduce_(dim_ind, spline_.integrate_along(dim_ind, a, b));
+    }
+
+    /**
+     * @brief Get definite integral along one dimension over its whole range,
+     * the result is an interpolation function of one dimension lower.
+     *
+     * @param dim_ind dimension index
+     */
+    template <size_type D_ = dim>
+    typename std::enable_if<(D_ > 1),
+                            InterpolationFunction<val_type, D_ - 1>>::type
+    integrate_along(size_type dim_ind) const {
+        return integrate_along(dim_ind, range(dim_ind).first,
+                               range(dim_ind).second);
+    }
+
+    /**
+     * @brief Fix coordinate of one dimension, the result is an interpolation
+     * function of one dimension lower. Knot lookup and base spline of the
+     * fixed coordinate are computed once, and control points are contracted
+     * with them, so evaluating the result is much cheaper than evaluating
+     * this function with the coordinate repeated.
+     *
+     * @param dim_ind dimension index
+     * @param x coordinate
+     */
+    template <size_type D_ = dim>
+    typename std::enable_if<(D_ > 1),
+                            InterpolationFunction<val_type, D_ - 1>>::type
+    bind(size_type dim_ind, coord_type x) const {
+        if (dim_ind >= dim) {
+            throw std::range_error("Dimension index out of range.");
+        }
+        return reduce_(dim_ind,
+                       spline_.bind(dim_ind, x, knot_hint_(dim_ind, x)));
+    }
+
+    /**
+     * @brief Restrict the function to hyperplane x_k = c, i.e. `bind` with
+     * range check. The result is exact, as its control points are the
+     * contraction of control points with base spline values at c.
+     *
+     * @param dim_ind dimension index k
+     * @param x coordinate c, within range unless the dimension is periodic
+     */
+    template <size_type D_ = dim>
+    typename std::enable_if<(D_ > 1),
+                            InterpolationFunction<val_type, D_ - 1>>::type
+    slice(size_type dim_ind, coord_type x) const {
+        if (dim_ind >= dim) {
+            throw std::range_error("Dimension index out of range.");
+        }
+        if (!periodicity_[dim_ind] &&
+            (x < range(dim_ind).first || x > range(dim_ind).second)) {
+            throw std::domain_error(
+                "Given coordinate out of interpolation function range!");
+        }
+        return bind(dim_ind, x);
+    }
+
+    /**
+     * @brief Fix coordinates of K dimensions, the result is an interpolation
+     * function of the other dimensions, in their original order. For example,
+     * `f.bind<2>({0, 2}, {x, z})` of a 3D function f is y -> f(x, y, z).
+     *
+     * @param dim_inds distinct dimension indices
+     * @param coords coordinates of these dimensions
+     */
+    template <size_type K, size_type D_ = dim>
+    typename std::enable_if<(K > 0 && K < D_),
+                            InterpolationFunction<val_type, D_ - K>>::type
+    bind(std::array<size_type, K> dim_inds,
+         std::array<coord_type, K> coords) const {
+        // bind the last dimension first, leaving indices of others unchanged
+        size_type last = 0;
+        for (size_type k = 0; k < K; ++k) {
+            if (dim_inds[k] >= dim) {
+                throw std::range_error("Dimension index out of range.");
+            }
+            for (size_type k_ = 0; k_ < k; ++k_) {
+                if (dim_inds[k_] == dim_inds[k]) {
+                    throw std::domain_error("Dimension is bound twice.");
+                }
+            }
+            if (dim_inds[k] > dim_inds[last]) { last = k; }
+        }
+        const auto reduced = bind(dim_inds[last], coords[last]);
+
+        std::array<size_type, K - 1> rest_inds;
+        std::array<coord_type, K - 1> rest_coords;
+        for (size_type k = 0, r = 0; k < K; ++k) {
+            if (k == last) { continue; }
+            rest_inds[r] = dim_inds[k];
+            rest_coords[r++] = coords[k];
+        }
+        return reduced.template bind<K - 1>(rest_inds, rest_coords);
+    }
+
+    template <size_type K, size_type D_ = dim>
+    typename std::enable_if<K == 0, InterpolationFunction>::type bind(
+        std::array<size_type, K>,
+        std::array<coord_type, K>) const {
+        return *this;
+    }
+
+    /**
+     * @brief Get the antiderivative of 1D function, which vanishes at the
+     * lower end of range. Evaluating it costs a single spline evaluation.
+     *
+     * @return a B-spline of one order higher
+     */
+    template <size_type D_ = dim>
+    typename std::enable_if<D_ == 1, spline_type>::type antiderivative()
+        const {
+        return spline_.antiderivative();
+    }
+
+    /**
+     * @brief Find coordinate where 1D function takes the given value, e.g.
+     * inverting a monotone table. The function is supposed to be monotone,
+     * otherwise one of the solutions is returned.
+     *
+     * @param y function value
+     */
+    template <size_type D_ = dim>
+    typename std::enable_if<D_ == 1, coord_type>::type inverse(
+        val_type y) const {
+        return spline_.inverse(y);
+    }
+
+    /**
+     * @brief Find coordinates for a batch of function values. Sorted values
+     * are solved faster.
+     *
+     * @param first begin iterator of function values
+     * @param last end iterator of function values
+     * @param d_first begin iterator of output coordinates
+     * @return output iterator to the element past the last one written
+     */
+    template <typename InputIter,
+              typename OutputIter,
+              size_type D_ = dim,
+              typename = typename std::enable_if<D_ == 1>::type>
+    OutputIter inverse(InputIter first,
+                       InputIter last,
+                       OutputIter d_first) const {
+        return spline_.inverse(first, last, d_first);
+    }
+
+    /**
+     * @brief Build interpolation function of the inverse of a monotone 1D
+     * function, on uniformly sampled function values. Evaluating it is much
+     * cheaper than solving for inverse, at the cost of interpolation error.
+     *
+     * @param sample_num number of samples of function value
+     * @param spline_order order of the inverse interpolation function
+     */
+    template <size_type D_ = dim>
+    typename std::enable_if<D_ == 1, InterpolationFunction>::type
+    inverse_function(size_type sample_num, size_type spline_order = 3) const {
+        if (periodicity_[0]) {
+            throw std::domain_error(
+                "Periodic function has no inverse function!");
+        }
+        if (sample_num < std::max(spline_order + 1, size_type{2})) {
+            throw std::domain_error(
+                "Too few samples for inverse function of given order!");
+        }
+        const val_type y_begin = (*this)(range(0).first);
+        const val_type y_end = (*this)(range(0).second);
+        const val_type y_min = std::min(y_begin, y_end);
+        const val_type y_max = std::max(y_begin, y_end);
+
+        std::vector<val_type> ys(sample_num);
+        for (size_type i = 0; i < sample_num; ++i) {
+            ys[i] = y_min + (y_max - y_min) * static_cast<val_type>(i) /
+                                static_cast<val_type>(sample_num - 1);
+        }
+        std::vector<coord_type> xs(sample_num);
+        inverse(ys.begin(), ys.end(), xs.begin());
+        // ends are exact, free from round-off in solving
+        xs.front() = y_begin <= y_end ? range(0).first : range(0).second;
+        xs.back() = y_begin <= y_end ? range(0).second : range(0).first;
+
+        return InterpolationFunction(spline_order, false,
+                                     std::make_pair(xs.begin(), xs.end()),
+                                     std::make_pair(y_min, y_max));
+    }
+
+    /**
+     * @brief Get partial derivative as a new interpolation function. Control
+     * points of derivative are computed once here, thus evaluating it costs
+     * the same as evaluating a function value.
+     *
+     * @param derivatives derivative order array
+     */
+    InterpolationFunction differentiate(DimArray<size_type> derivatives) const {
+        return InterpolationFunction(spline_.differentiate(derivatives), dx_,
+                                     uniform_);
+    }
+
+    /**
+     * @brief Get partial derivative as a new interpolation function.
+     *
+     * @param deriOrder derivative orders
+     */
+    template <typename... Args>
+    typename std::enable_if<sizeof...(Args) == dim,
+                            InterpolationFunction>::type
+    differentiate(Args... deriOrder) const {
+        return differentiate(
+            DimArray<size_type>{static_cast<size_type>(deriOrder)...});
+    }
+
+    /**
+     * @brief Convert to piecewise polynomial form, which is faster to evaluate
+     * but takes more memory.
+     *
+     */
+    PiecewisePolynomial<val_type, dim> pp_form() const {
+        return PiecewisePolynomial<val_type, dim>(spline_);
+    }
+
     // properties
 
     bool periodicity(size_type dim_ind) const {
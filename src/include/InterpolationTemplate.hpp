@@ -3,8 +3,24 @@
 
 #include "BSpline.hpp"
 #include "BandLU.hpp"
+#include "Instrumentation.hpp"
 #include "Mesh.hpp"
 
+#include <algorithm>  // min, max, max_element
+#include <cmath>      // abs
+#include <cstdint>
+#include <fstream>
+#include <functional>  // multiplies
+#include <map>
+#include <memory>  // shared_ptr
+#include <mutex>
+#include <numeric>  // accumulate
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>  // tie
+#include <vector>
+
 #if __cplusplus >= 201703L
 #include <variant>
 #endif
@@ -19,6 +35,29 @@ template <typename T, size_t D>
 class InterpolationFunction;  // Forward declaration, since template has
                               // a member of it.
 
+template <typename T, size_t D>
+class SplineCollection;
+
+/**
+ * @brief Engine solving for control points along uniform aperiodic dimensions.
+ * `band_lu` factorizes the coefficient matrix by band LU, while
+ * `recursive_filter` applies the inverse B-spline kernel by recursive (IIR)
+ * filtering, with rows near boundaries corrected so that both engines give
+ * the same control points.
+ *
+ */
+enum class FittingEngine { band_lu, recursive_filter };
+
+/**
+ * @brief Memory access pattern of sweeping a dimension while solving for
+ * control points. `strided` solves each line in place through a strided
+ * iterator, while `tiled` solves a tile of adjacent lines at once, row by row
+ * across the lines, so that the mesh is traversed sequentially even along
+ * dimensions of large stride.
+ *
+ */
+enum class SweepStrategy { strided, tiled };
+
 /**
  * @brief Template for interpolation with only coordinates, and generate
  * interpolation function when fed by function values.
@@ -62,16 +101,16 @@ class InterpolationFunctionTemplate {
                 mesh_dimension_,
                 x_ranges...),
           solvers_{} {
-        // active union member accordingly
-        for (size_type i = 0; i < dim; ++i) {
-#if __cplusplus >= 201703L
-            if (periodicity[i]) {
-                solvers_[i].template emplace<extended_solver_type>();
-            } else {
-                solvers_[i].template emplace<base_solver_type>();
-            }
-#endif
+        // adjust dimension according to periodicity
+        DimArray<size_type> dim_size_tmp;
+        for (size_type d = 0; d < dim; ++d) {
+            dim_size_tmp[d] =
+                mesh_dimension_.dim_size(d) - (periodicity[d] ? 1 : 0);
         }
+        // control points are always stored in row-major order, whatever the
+        // layout of data is
+        mesh_dimension_ = MeshDim{dim_size_tmp, Layout::row_major};
+
         build_solver_();
     }
 
@@ -121,26 +160,420 @@ class InterpolationFunctionTemplate {
                                         interp_mesh_dimension,
                                         x_ranges...) {}
 
+    /**
+     * @brief Select fitting engine of uniform aperiodic dimensions. Solvers
+     * are rebuilt if it changes.
+     *
+     */
+    void fitting_engine(FittingEngine engine) {
+        if (engine == engine_) { return; }
+        engine_ = engine;
+        build_solver_();
+    }
+
+    FittingEngine fitting_engine() const { return engine_; }
+
+    /**
+     * @brief Select memory access pattern of dimension sweeps in fitting. It
+     * does not change the result.
+     *
+     */
+    void sweep_strategy(SweepStrategy strategy) { sweep_ = strategy; }
+
+    SweepStrategy sweep_strategy() const { return sweep_; }
+
+    /**
+     * @brief Release cached factorizations not used by any template, e.g.
+     * after fitting on a large nonuniform grid for the last time.
+     *
+     */
+    static void release_solver_cache() {
+        auto& cache = solver_cache_();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        cache.trim(0);
+    }
+
+    /**
+     * @brief Generate an interpolation function from interpolated values. A
+     * mesh or a mesh view (of any layout) is read in place, while other
+     * arguments (e.g. an iterator pair in 1D) are converted to a mesh first.
+     *
+     */
     template <typename MeshOrIterPair>
     function_type interpolate(MeshOrIterPair&& mesh_or_iter_pair) const& {
         function_type interp{base_};
-        interp.spline_.load_ctrlPts(
-            solve_for_control_points_(Mesh<val_type, dim>{
-                std::forward<MeshOrIterPair>(mesh_or_iter_pair)}));
+        interp.spline_.load_ctrlPts(solve_for_control_points_(
+            input_mesh_(std::forward<MeshOrIterPair>(mesh_or_iter_pair))));
         return interp;
     }
 
     template <typename MeshOrIterPair>
     function_type interpolate(MeshOrIterPair&& mesh_or_iter_pair) && {
-        base_.spline_.load_ctrlPts(
-            solve_for_control_points_(Mesh<val_type, dim>{
-                std::forward<MeshOrIterPair>(mesh_or_iter_pair)}));
+        base_.spline_.load_ctrlPts(solve_for_control_points_(
+            input_mesh_(std::forward<MeshOrIterPair>(mesh_or_iter_pair))));
         return std::move(base_);
     }
 
+    /**
+     * @brief Fit many series sharing the grid of this 1D template. The
+     * coefficient matrix is factorized once, and series are solved in blocks
+     * of `batch_width_`, with the innermost loop running across series of a
+     * block. Blocks are distributed over threads.
+     *
+     * @param series values of one series in each row, i.e. of size (number of
+     * series) x (number of data points), in any layout
+     * @param thread_num number of threads solving blocks
+     * @return splines of all series, sharing knots
+     */
+    SplineCollection<val_type, 1> interpolate_batch(
+        MeshView<const val_type, 2> series,
+        size_type thread_num = 1) const {
+        static_assert(dim == size_type{1},
+                      "You can only use batch interpolation in 1D case.");
+        INTP_TIME_SCOPE(solves, solve_ns);
+        const size_type n = mesh_dimension_.dim_size(0);
+        const size_type series_num = series.dim_size(0);
+        if (series.dim_size(1) != n + (base_.periodicity(0) ? 1 : 0)) {
+            throw std::range_error("Length of series mismatches the template.");
+        }
+
+        Mesh<val_type, 2> ctrl_pts{series_num, n};
+        const size_type block_num =
+            (series_num + batch_width_ - 1) / batch_width_;
+        const auto solve_blocks = [&](size_type b_begin, size_type b_end) {
+            std::vector<val_type> block(n * batch_width_);
+            for (size_type b = b_begin; b < b_end; ++b) {
+                const size_type s0 = b * batch_width_;
+                const size_type width =
+                    std::min(batch_width_, series_num - s0);
+                // Rows are shifted in periodic case as in `interpolate`, and
+                // the last point is skipped.
+                for (size_type s = 0; s < width; ++s) {
+                    for (size_type i = 0; i < n; ++i) {
+                        const size_type row = base_.periodicity(0)
+                                                  ? (i + base_.order / 2) % n
+                                                  : i;
+                        block[row * width + s] = series(s0 + s, i);
+                    }
+                }
+                solve_tile_(block.data(), width, width, 0);
+                for (size_type s = 0; s < width; ++s) {
+                    for (size_type i = 0; i < n; ++i) {
+                        ctrl_pts(s0 + s, i) = block[i * width + s];
+                    }
+                }
+            }
+        };
+
+        thread_num = std::max(size_type{1}, std::min(thread_num, block_num));
+        std::vector<std::thread> threads;
+        for (size_type t = 1; t < thread_num; ++t) {
+            threads.emplace_back(solve_blocks, block_num * t / thread_num,
+                                 block_num * (t + 1) / thread_num);
+        }
+        solve_blocks(0, block_num / thread_num);
+        for (auto& t : threads) { t.join(); }
+
+        return SplineCollection<val_type, 1>{base_, std::move(ctrl_pts)};
+    }
+
+    /**
+     * @brief Update an interpolation function generated by this template when
+     * interpolated values change in a sub-box of the data mesh. The change of
+     * control points is solved along each dimension in turn, by full-length
+     * solves of the lines crossing the region it has spread to so far. After
+     * each dimension the region is cut where the change is no larger than
+     * tolerance. The cost of dimension d is thus n_d times the cross-section
+     * of the region, which stays close to the box when the change decays fast
+     * (and reaches the whole mesh for an exact update).
+     *
+     * The residual is evaluated only in the box, so deviations left by
+     * truncated updates are never corrected by later ones, and they add up.
+     * The returned bound can be summed over updates to decide when to refit.
+     *
+     * @param interp function to be updated, generated by this template
+     * @param box_begin data mesh indices of the first corner of the sub-box
+     * @param values new interpolated values in the sub-box
+     * @param tolerance absolute truncation threshold of control point change,
+     * zero for an update exact up to round-off error
+     * @return bound of the deviation from an exact update, of control points
+     * and (B-splines being a partition of unity) of the function
+     */
+    val_type update(function_type& interp,
+                    DimArray<size_type> box_begin,
+                    const Mesh<val_type, dim>& values,
+                    val_type tolerance = 0) const {
+        INTP_TIME_SCOPE(solves, solve_ns);
+        auto& ctrl_pts = interp.spline_.control_points_;
+        for (size_type d = 0; d < dim; ++d) {
+            if (ctrl_pts.dim_size(d) != mesh_dimension_.dim_size(d) ||
+                interp.periodicity_[d] != base_.periodicity(d)) {
+                throw std::domain_error(
+                    "Interpolation function is not generated by this "
+                    "template.");
+            }
+            if (box_begin[d] + values.dim_size(d) >
+                mesh_dimension_.dim_size(d) + (base_.periodicity(d) ? 1 : 0)) {
+                throw std::range_error(
+                    std::string("Updated box exceeds data mesh at dimension ") +
+                    std::to_string(d));
+            }
+        }
+
+        // Indices (of control points) spanned by the change along each
+        // dimension, and the change itself on the mesh they span. In periodic
+        // dimensions the indices are shifted as in fitting.
+        DimArray<std::vector<size_type>> support;
+        MeshDim local_dimension;
+        {
+            DimArray<size_type> sizes;
+            for (size_type d = 0; d < dim; ++d) {
+                for (size_type i = 0; i < values.dim_size(d); ++i) {
+                    const size_type ind = box_begin[d] + i;
+                    // last point of periodic dimension duplicates the first
+                    if (base_.periodicity(d) &&
+                        ind == mesh_dimension_.dim_size(d)) {
+                        continue;
+                    }
+                    support[d].push_back(
+                        base_.periodicity(d)
+                            ? (ind + base_.order / 2) %
+                                  mesh_dimension_.dim_size(d)
+                            : ind);
+                }
+                sizes[d] = support[d].size();
+            }
+            local_dimension.resize(sizes);
+        }
+        if (local_dimension.size() == 0) { return val_type{}; }
+        Mesh<val_type, dim> change{local_dimension};
+        for (auto it = values.begin(); it != values.end(); ++it) {
+            const auto box_ind = values.iter_indices(it);
+            DimArray<coord_type> coord;
+            bool keep_flag = true;
+            for (size_type d = 0; d < dim; ++d) {
+                const size_type ind = box_begin[d] + box_ind[d];
+                keep_flag = keep_flag && !(base_.periodicity(d) &&
+                                           ind == mesh_dimension_.dim_size(d));
+                // periodic spline of even order starts half a grid spacing
+                // before the data grid
+                coord[d] =
+                    base_.uniform(d)
+                        ? base_.spline().range(d).first +
+                              static_cast<coord_type>(ind) * base_.dx_[d] +
+                              (base_.periodicity(d) && base_.order % 2 == 0
+                                   ? base_.dx_[d] / 2
+                                   : coord_type{})
+                        : input_coords_[d][ind];
+            }
+            // residual of current interpolation function
+            if (keep_flag) { change(box_ind) = *it - interp(coord); }
+        }
+
+        // Change dropped before dimension d is not solved along it, which
+        // multiplies the deviation by at most the infinity norm of inverse
+        // coefficient matrix.
+        val_type dropped{};
+        for (size_type d = 0; d < dim; ++d) {
+            val_type dropped_d{};
+            change = spread_change_(change, support, d, tolerance, dropped_d);
+            if (dropped != val_type{}) {
+#if __cplusplus >= 201703L
+                dropped *= std::visit(
+                    [](auto& solver) { return solver.inverse_norm_bound(); },
+                    *solvers_[d]);
+#else
+                dropped *= solvers_[d]->inverse_norm_bound();
+#endif
+            }
+            dropped += dropped_d;
+        }
+
+        for (auto it = change.begin(); it != change.end(); ++it) {
+            auto ind = change.iter_indices(it);
+            for (size_type d = 0; d < dim; ++d) {
+                ind[d] = support[d][ind[d]];
+            }
+            ctrl_pts(ind) += *it;
+        }
+        return dropped;
+    }
+
+    /**
+     * @brief Fit data too large to be held in memory. Dimensions except the
+     * first are solved on slabs of consecutive hyperplanes, one slab at a
+     * time, then the first dimension is solved on column blocks spanning all
+     * hyperplanes. By tensor separability the result equals that of
+     * `interpolate`.
+     *
+     * Both files are raw binary arrays of val_type in row-major order. The
+     * input holds data on the whole mesh given on construction, and the
+     * output holds control points on the mesh of `control_point_dimension()`
+     * (which can be memory mapped, or read back by `load`).
+     *
+     * @param input_file path of data file
+     * @param output_file path of control point file, overwritten
+     * @param memory_budget maximum bytes of buffers, besides a reserve of
+     * 256 KiB it should hold a hyperplane of both control points and data,
+     * and a line along the first dimension, or std::runtime_error is thrown
+     */
+    void interpolate_out_of_core(const std::string& input_file,
+                                 const std::string& output_file,
+                                 size_type memory_budget) const {
+        INTP_TIME_SCOPE(solves, solve_ns);
+        const size_type n = mesh_dimension_.dim_size(0);
+        const size_type plane_size = mesh_dimension_.size() / n;
+        DimArray<size_type> data_sizes;
+        for (size_type d = 0; d < dim; ++d) {
+            data_sizes[d] =
+                mesh_dimension_.dim_size(d) + (base_.periodicity(d) ? 1 : 0);
+        }
+        const size_type data_plane_size =
+            std::accumulate(data_sizes.begin() + 1, data_sizes.end(),
+                            size_type{1}, std::multiplies<size_type>{});
+        // The slab phase holds a slab of at least one hyperplane besides a
+        // data hyperplane, and the column phase a block of at least one line.
+        if (std::max(plane_size + data_plane_size, n) * sizeof(val_type) +
+                sweep_tile_bytes_ >
+            memory_budget) {
+            throw std::runtime_error(
+                "Memory budget is too small for out-of-core fitting.");
+        }
+
+        std::ifstream input(input_file, std::ios::binary);
+        std::fstream output(output_file, std::ios::binary | std::ios::in |
+                                             std::ios::out | std::ios::trunc);
+        if (!input || !output) {
+            throw std::runtime_error(
+                "Cannot open file for out-of-core fitting.");
+        }
+        input.seekg(0, std::ios::end);
+        if (static_cast<size_type>(input.tellg()) !=
+            data_sizes[0] * data_plane_size * sizeof(val_type)) {
+            throw std::range_error(
+                "Size of data file mismatches mesh dimension.");
+        }
+
+        // slabs of hyperplanes, solved in all dimensions except the first
+        {
+            const size_type slab_planes = std::min(
+                n, (memory_budget - sweep_tile_bytes_ -
+                    data_plane_size * sizeof(val_type)) /
+                       (plane_size * sizeof(val_type)));
+            std::vector<val_type> data_plane(data_plane_size);
+            DimArray<size_type> data_plane_sizes = data_sizes;
+            data_plane_sizes[0] = 1;
+            MeshDim data_plane_dimension;
+            data_plane_dimension.resize(data_plane_sizes);
+
+            for (size_type p0 = 0; p0 < n; p0 += slab_planes) {
+                DimArray<size_type> slab_sizes;
+                for (size_type d = 0; d < dim; ++d) {
+                    slab_sizes[d] = d == 0 ? std::min(slab_planes, n - p0)
+                                           : mesh_dimension_.dim_size(d);
+                }
+                MeshDim slab_dimension;
+                slab_dimension.resize(slab_sizes);
+                Mesh<val_type, dim> slab{slab_dimension};
+
+                for (size_type p = 0; p < slab_sizes[0]; ++p) {
+                    // data hyperplane of control point hyperplane, shifted as
+                    // in `solve_for_control_points_`
+                    const size_type data_p =
+                        base_.periodicity(0)
+                            ? (p0 + p + n - base_.order / 2) % n
+                            : p0 + p;
+                    input.seekg(static_cast<std::streamoff>(
+                        data_p * data_plane_size * sizeof(val_type)));
+                    read_values_(input, data_plane.data(), data_plane_size);
+                    for (size_type i = 0; i < data_plane_size; ++i) {
+                        auto indices = data_plane_dimension.dimwise_indices(i);
+                        bool keep_flag = true;
+                        for (size_type d = 1; d < dim; ++d) {
+                            if (base_.periodicity(d)) {
+                                const size_type m = mesh_dimension_.dim_size(d);
+                                keep_flag = keep_flag && indices[d] != m;
+                                indices[d] =
+                                    (indices[d] + m + base_.order / 2) % m;
+                            }
+                        }
+                        indices[0] = p;
+                        if (keep_flag) { slab(indices) = data_plane[i]; }
+                    }
+                }
+
+                for (size_type d = 1; d < dim; ++d) {
+                    sweep_dimension_(slab, d);
+                }
+                output.seekp(static_cast<std::streamoff>(
+                    p0 * plane_size * sizeof(val_type)));
+                write_values_(output, slab.data(), slab.size());
+            }
+        }
+
+        // column blocks, solved in the first dimension
+        {
+            const size_type block_width =
+                std::min(plane_size, (memory_budget - sweep_tile_bytes_) /
+                                         (n * sizeof(val_type)));
+            const size_type tile = tile_width_(n, block_width);
+            std::vector<val_type> block(n * block_width);
+            for (size_type j0 = 0; j0 < plane_size; j0 += block_width) {
+                const size_type width = std::min(block_width, plane_size - j0);
+                for (size_type i = 0; i < n; ++i) {
+                    output.seekg(static_cast<std::streamoff>(
+                        (i * plane_size + j0) * sizeof(val_type)));
+                    read_values_(output, block.data() + i * width, width);
+                }
+                for (size_type j = 0; j < width; j += tile) {
+                    solve_tile_(block.data() + j, width,
+                                std::min(tile, width - j), 0);
+                }
+                for (size_type i = 0; i < n; ++i) {
+                    output.seekp(static_cast<std::streamoff>(
+                        (i * plane_size + j0) * sizeof(val_type)));
+                    write_values_(output, block.data() + i * width, width);
+                }
+            }
+        }
+
+        output.flush();
+        if (!output) {
+            throw std::runtime_error("Failed to write control point file.");
+        }
+    }
+
+    /**
+     * @brief Mesh dimension of control points, i.e. that of data with the
+     * last point of periodic dimensions dropped.
+     *
+     */
+    const MeshDim& control_point_dimension() const { return mesh_dimension_; }
+
+    /**
+     * @brief Generate interpolation function from a control point file
+     * written by `interpolate_out_of_core`.
+     *
+     */
+    function_type load(const std::string& control_point_file) const {
+        std::ifstream input(control_point_file, std::ios::binary);
+        if (!input) {
+            throw std::runtime_error("Cannot open control point file.");
+        }
+        Mesh<val_type, dim> ctrl_pts{mesh_dimension_};
+        read_values_(input, ctrl_pts.data(), ctrl_pts.size());
+        function_type interp{base_};
+        interp.spline_.load_ctrlPts(std::move(ctrl_pts));
+        return interp;
+    }
+
    private:
     using base_solver_type = BandLU<BandMatrix<val_type>>;
     using extended_solver_type = BandLU<ExtendedBandMatrix<val_type>>;
+    // for periodic dimension on uniform grid
+    using circulant_solver_type = BandLU<CirculantBandMatrix<val_type>>;
+    // for aperiodic dimension on uniform grid, if selected
+    using recursive_solver_type = RecursiveFilter<BandMatrix<val_type>>;
 
     // input coordinates, needed only in nonuniform case
     DimArray<typename function_type::spline_type::KnotContainer> input_coords_;
@@ -151,264 +584,524 @@ class InterpolationFunctionTemplate {
     function_type base_;
 
 #if __cplusplus >= 201703L
-    using EitherSolver = std::variant<base_solver_type, extended_solver_type>;
+    using EitherSolver = std::variant<base_solver_type,
+                                      extended_solver_type,
+                                      circulant_solver_type,
+                                      recursive_solver_type>;
 #else
-    // A union-like class storing BandLU solver for Either band matrix or
-    // extended band matrix
+    // A union-like class storing BandLU solver for band matrix, extended band
+    // matrix or circulant band matrix, or recursive filter
     struct EitherSolver {
-        // set default active union member, or g++ compiled code will throw
-        // err
-        EitherSolver() {}
+        enum class Kind { aperiodic, periodic, circulant, recursive };
+
         // Active union member and tag it.
-        EitherSolver(bool is_periodic)
-            : is_active_(true), is_periodic_(is_periodic) {
-            if (is_periodic_) {
-                new (&solver_periodic) extended_solver_type;
-            } else {
-                new (&solver_aperiodic) base_solver_type;
+        explicit EitherSolver(Kind kind) : kind_(kind) {
+            switch (kind_) {
+                case Kind::aperiodic:
+                    new (&solver_aperiodic) base_solver_type;
+                    break;
+                case Kind::periodic:
+                    new (&solver_periodic) extended_solver_type;
+                    break;
+                case Kind::circulant:
+                    new (&solver_circulant) circulant_solver_type;
+                    break;
+                case Kind::recursive:
+                    new (&solver_recursive) recursive_solver_type;
+                    break;
             }
         }
-        EitherSolver& operator=(bool is_periodic) {
-            if (is_active_) {
-                throw std::runtime_error("Can not switch solver type.");
+
+        // Solvers are shared by pointer and never copied.
+        EitherSolver(const EitherSolver&) = delete;
+        EitherSolver& operator=(const EitherSolver&) = delete;
+
+        // Destructor needed and it invokes the active member's destructor
+        // according to the tag "kind_";
+        ~EitherSolver() {
+            switch (kind_) {
+                case Kind::aperiodic:
+                    solver_aperiodic.~base_solver_type();
+                    break;
+                case Kind::periodic:
+                    solver_periodic.~extended_solver_type();
+                    break;
+                case Kind::circulant:
+                    solver_circulant.~circulant_solver_type();
+                    break;
+                case Kind::recursive:
+                    solver_recursive.~recursive_solver_type();
+                    break;
             }
+        }
 
-            is_active_ = true;
-            is_periodic_ = is_periodic;
-            if (is_periodic_) {
-                new (&solver_periodic) extended_solver_type;
-            } else {
-                new (&solver_aperiodic) base_solver_type;
+        template <typename Iter>
+        void solve(Iter&& iter) const {
+            switch (kind_) {
+                case Kind::aperiodic:
+                    solver_aperiodic.solve(std::forward<Iter>(iter));
+                    break;
+                case Kind::periodic:
+                    solver_periodic.solve(std::forward<Iter>(iter));
+                    break;
+                case Kind::circulant:
+                    solver_circulant.solve(std::forward<Iter>(iter));
+                    break;
+                case Kind::recursive:
+                    solver_recursive.solve(std::forward<Iter>(iter));
+                    break;
             }
+        }
 
-            return *this;
+        void solve_block_in_place(val_type* block,
+                                  size_type pitch,
+                                  size_type width) const {
+            switch (kind_) {
+                case Kind::aperiodic:
+                    solver_aperiodic.solve_block_in_place(block, pitch, width);
+                    break;
+                case Kind::periodic:
+                    solver_periodic.solve_block_in_place(block, pitch, width);
+                    break;
+                case Kind::circulant:
+                    solver_circulant.solve_block_in_place(block, pitch, width);
+                    break;
+                case Kind::recursive:
+                    solver_recursive.solve_block_in_place(block, pitch, width);
+                    break;
+            }
         }
 
-        // Copy constructor is required by aggregate initialization, but never
-        // invoked in this code since the content of this union is never
-        // switched.
-        EitherSolver(const EitherSolver&) {}
-        // Destructor needed and it invokes either member's destructor according
-        // to the tag "is_periodic";
-        ~EitherSolver() {
-            if (is_active_) {
-                if (is_periodic_) {
-                    solver_periodic.~extended_solver_type();
-                } else {
-                    solver_aperiodic.~base_solver_type();
-                }
+        val_type inverse_norm_bound() const {
+            switch (kind_) {
+                case Kind::aperiodic:
+                    return solver_aperiodic.inverse_norm_bound();
+                case Kind::periodic:
+                    return solver_periodic.inverse_norm_bound();
+                case Kind::circulant:
+                    return solver_circulant.inverse_norm_bound();
+                case Kind::recursive:
+                    return solver_recursive.inverse_norm_bound();
             }
+            return val_type{};
         }
 
         union {
             base_solver_type solver_aperiodic;
             extended_solver_type solver_periodic;
+            circulant_solver_type solver_circulant;
+            recursive_solver_type solver_recursive;
         };
 
-        bool is_active_ = false;
         // tag for union member
-        bool is_periodic_ = false;
+        Kind kind_;
     };
 #endif
 
+    /**
+     * @brief Key of coefficient matrix of one dimension. The matrix is
+     * determined by spline order, periodicity and point number, plus input
+     * coordinates if the dimension is nonuniform. (Uniform knots are scale
+     * invariant, so coordinates are left empty in that case.)
+     *
+     */
+    struct SolverKey {
+        size_type order;
+        bool periodic;
+        size_type n;
+        std::vector<coord_type> coords;
+        bool recursive;
+
+        bool operator<(const SolverKey& other) const {
+            return std::tie(order, periodic, n, coords, recursive) <
+                   std::tie(other.order, other.periodic, other.n,
+                            other.coords, other.recursive);
+        }
+    };
+
+    /**
+     * @brief Process-wide cache of factorized coefficient matrices, shared by
+     * all templates (and dimensions) of the same value type and dimension.
+     * Besides those in use, it keeps the most recently used factorizations
+     * alive, so that functions constructed one after another on the same grid
+     * factorize only once.
+     *
+     */
+    struct SolverCache {
+        std::mutex mutex;
+        // solver and the tick of its last use
+        std::map<SolverKey,
+                 std::pair<std::shared_ptr<const EitherSolver>, std::uint64_t>>
+            solvers;
+        std::uint64_t tick = 0;
+
+        /**
+         * @brief Drop least recently used entries not used by any template,
+         * until at most `capacity` of them remain. The lock should be held.
+         *
+         */
+        void trim(size_type capacity) {
+            for (;;) {
+                size_type unused = 0;
+                auto lru = solvers.end();
+                for (auto it = solvers.begin(); it != solvers.end(); ++it) {
+                    if (it->second.first.use_count() > 1) { continue; }
+                    ++unused;
+                    if (lru == solvers.end() ||
+                        it->second.second < lru->second.second) {
+                        lru = it;
+                    }
+                }
+                if (unused <= capacity) { break; }
+                solvers.erase(lru);
+            }
+        }
+    };
+
+    static SolverCache& solver_cache_() {
+        static SolverCache cache;
+        return cache;
+    }
+
+    // number of factorizations kept by cache while no template uses them
+    static constexpr size_type solver_cache_capacity_ = 8;
+
     // solver for weights
-    DimArray<EitherSolver> solvers_;
+    DimArray<std::shared_ptr<const EitherSolver>> solvers_;
+
+    FittingEngine engine_ = FittingEngine::band_lu;
+
+    SweepStrategy sweep_ = SweepStrategy::tiled;
+
+    // budget of a tile solved in place, n times its width of values, which
+    // bounds the tile width so that the tile stays in L2 cache
+    static constexpr size_type sweep_tile_bytes_ = size_type{1} << 18;
+
+    // series solved at once in batch interpolation
+    static constexpr size_type batch_width_ = 16;
+
+    /**
+     * @brief Whether recursive filter is used in given dimension. It requires
+     * enough points for the boundary correction to be negligible in cost.
+     *
+     */
+    bool use_recursive_filter_(size_type d) const {
+        return engine_ == FittingEngine::recursive_filter &&
+               !base_.periodicity(d) && base_.uniform(d) &&
+               mesh_dimension_.dim_size(d) >= 8 * (base_.order + 1);
+    }
 
     void build_solver_() {
-        const auto& order = base_.order;
-        // adjust dimension according to periodicity
-        {
-            DimArray<size_type> dim_size_tmp;
-            for (size_type d = 0; d < dim; ++d) {
-                dim_size_tmp[d] = mesh_dimension_.dim_size(d) -
-                                  (base_.periodicity(d) ? 1 : 0);
+        INTP_TIME_SCOPE(solver_builds, solver_build_ns);
+
+#ifdef _TRACE
+        std::cout << "\n[TRACE] Coefficient Matrices\n";
+#endif
+
+        auto& cache = solver_cache_();
+        DimArray<SolverKey> keys;
+        // dimensions to be factorized, each being the first of its key
+        std::vector<size_type> to_make;
+        // the dimension whose solver is shared, for those not found in cache
+        DimArray<size_type> source;
+        for (size_type d = 0; d < dim; ++d) {
+            keys[d] = SolverKey{base_.order, base_.periodicity(d),
+                                mesh_dimension_.dim_size(d), {},
+                                use_recursive_filter_(d)};
+            if (!base_.uniform(d)) {
+                keys[d].coords.assign(input_coords_[d].begin(),
+                                      input_coords_[d].end());
+            }
+
+            solvers_[d].reset();
+            {
+                std::lock_guard<std::mutex> lock(cache.mutex);
+                auto it = cache.solvers.find(keys[d]);
+                if (it != cache.solvers.end()) {
+                    solvers_[d] = it->second.first;
+                    it->second.second = ++cache.tick;
+                }
+            }
+            source[d] = d;
+            for (auto d_ : to_make) {
+                if (!(keys[d_] < keys[d]) && !(keys[d] < keys[d_])) {
+                    source[d] = d_;
+                }
             }
-            mesh_dimension_.resize(dim_size_tmp);
+            if (solvers_[d] || source[d] != d) {
+                INTP_COUNT(solver_cache_hits);
+                continue;
+            }
+            to_make.push_back(d);
         }
 
-        DimArray<typename function_type::spline_type::BaseSpline>
-            base_spline_vals_per_dim;
+        // Assemble and factorize without holding the lock, distinct
+        // dimensions being independent.
+        std::vector<std::shared_ptr<const EitherSolver>> made(to_make.size());
+#ifdef INTP_ENABLE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (size_type i = 0; i < to_make.size(); ++i) {
+            made[i] = make_solver_(to_make[i]);
+        }
+
+        // If another thread did the same meanwhile, use the one in cache.
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        for (size_type i = 0; i < to_make.size(); ++i) {
+            const size_type d = to_make[i];
+            auto& entry = cache.solvers[keys[d]];
+            if (!entry.first) { entry.first = std::move(made[i]); }
+            entry.second = ++cache.tick;
+            solvers_[d] = entry.first;
+        }
+        for (size_type d = 0; d < dim; ++d) {
+            if (!solvers_[d]) { solvers_[d] = solvers_[source[d]]; }
+        }
+        cache.trim(solver_cache_capacity_);
+    }
 
+    /**
+     * @brief Assemble coefficient matrix of one dimension and factorize it.
+     *
+     * @param d dimension index
+     */
+    std::shared_ptr<const EitherSolver> make_solver_(size_type d) const {
+        const auto& order = base_.order;
         const auto& spline = base_.spline();
 
+        typename function_type::spline_type::BaseSpline base_spline_vals;
         // pre-calculate base spline of periodic dimension, since it never
         // changes due to its even-spaced knots
-        for (size_type d = 0; d < dim; ++d) {
-            if (base_.periodicity(d) && base_.uniform(d)) {
-                base_spline_vals_per_dim[d] = spline.base_spline_value(
-                    d, spline.knots_begin(d) + static_cast<diff_type>(order),
-                    spline.knots_begin(d)[static_cast<diff_type>(order)] +
-                        (1 - order % 2) * base_.dx_[d] * .5);
-            }
+        if (base_.periodicity(d) && base_.uniform(d)) {
+            base_spline_vals = spline.base_spline_value(
+                d, spline.knots_begin(d) + static_cast<diff_type>(order),
+                spline.knots_begin(d)[static_cast<diff_type>(order)] +
+                    (1 - order % 2) * base_.dx_[d] * .5);
         }
 
-#ifdef _TRACE
-        std::cout << "\n[TRACE] Coefficient Matrices\n";
-#endif
+        bool periodic = base_.periodicity(d);
+        bool uniform = base_.uniform(d);
+        auto mat_dim = mesh_dimension_.dim_size(d);
+        auto band_width = periodic ? order / 2 : order - 1;
 
-        // loop through each dimension to construct coefficient matrix
-        for (size_type d = 0; d < dim; ++d) {
-            bool periodic = base_.periodicity(d);
-            bool uniform = base_.uniform(d);
-            auto mat_dim = mesh_dimension_.dim_size(d);
-            auto band_width = periodic ? order / 2 : order - 1;
+        // Coefficient matrix of periodic dimension on uniform grid is
+        // circulant, which has a dedicated solver. It needs distinct
+        // diagonals, hence a large enough dimension.
+        const bool circulant =
+            periodic && uniform && mat_dim > 2 * band_width;
 
 #if __cplusplus >= 201703L
-            std::variant<typename base_solver_type::matrix_type,
-                         typename extended_solver_type::matrix_type>
-                coef_mat;
-            if (periodic) {
-                coef_mat.template emplace<
-                    typename extended_solver_type::matrix_type>(
+        std::variant<typename base_solver_type::matrix_type,
+                     typename extended_solver_type::matrix_type,
+                     typename circulant_solver_type::matrix_type>
+            coef_mat;
+        if (circulant) {
+            coef_mat.template emplace<
+                typename circulant_solver_type::matrix_type>(
+                mat_dim, band_width, band_width);
+        } else if (periodic) {
+            coef_mat.template emplace<
+                typename extended_solver_type::matrix_type>(
+                mat_dim, band_width, band_width);
+        } else {
+            coef_mat
+                .template emplace<typename base_solver_type::matrix_type>(
                     mat_dim, band_width, band_width);
-            } else {
-                coef_mat
-                    .template emplace<typename base_solver_type::matrix_type>(
-                        mat_dim, band_width, band_width);
-            }
+        }
 #else
-            typename extended_solver_type::matrix_type coef_mat(
-                mat_dim, band_width, band_width);
+        typename extended_solver_type::matrix_type coef_mat(
+            mat_dim, band_width, band_width);
 #endif
 
 #ifdef _TRACE
-            std::cout << "\n[TRACE] Dimension " << d << '\n';
-            std::cout << "[TRACE] {0, 0} -> 1\n";
+        std::cout << "\n[TRACE] Dimension " << d << '\n';
+        std::cout << "[TRACE] {0, 0} -> 1\n";
 #endif
 
-            for (size_type i = 0; i < mesh_dimension_.dim_size(d); ++i) {
-                if (!periodic) {
-                    // In aperiodic case, first and last data point can only
-                    // be covered by one base spline, and the base spline at
-                    // these ending points eval to 1.
-                    if (i == 0 || i == mesh_dimension_.dim_size(d) - 1) {
+        for (size_type i = 0; i < mesh_dimension_.dim_size(d); ++i) {
+            if (!periodic) {
+                // In aperiodic case, first and last data point can only
+                // be covered by one base spline, and the base spline at
+                // these ending points eval to 1.
+                if (i == 0 || i == mesh_dimension_.dim_size(d) - 1) {
 #if __cplusplus >= 201703L
-                        std::visit([i](auto& m) { m(i, i) = 1; }, coef_mat);
+                    std::visit([i](auto& m) { m(i, i) = 1; }, coef_mat);
 #else
-                        coef_mat.main_bands_val(i, i) = 1;
+                    coef_mat.main_bands_val(i, i) = 1;
 #endif
-                        continue;
-                    }
+                    continue;
                 }
+            }
 
-                const auto knot_num = spline.knots_num(d);
-                // This is the index of knot point to the left of i-th
-                // interpolated value's coordinate, notice that knot points has
-                // a larger gap in both ends in non-periodic case.
-                size_type knot_ind{};
-                // flag for internal points in uniform aperiodic case
-                const bool is_internal =
-                    i > order / 2 &&
-                    i < mesh_dimension_.dim_size(d) - order / 2 - 1;
-
-                if (uniform) {
-                    knot_ind =
-                        periodic ? i + order
-                                 : std::min(knot_num - order - 2,
-                                            i > order / 2 ? i + (order + 1) / 2
-                                                          : order);
-                    if (!periodic) {
-                        if (knot_ind <= 2 * order + 1 ||
-                            knot_ind >= knot_num - 2 * order - 2) {
-                            // out of the zone of even-spaced knots, update base
-                            // spline
-                            const auto iter = spline.knots_begin(d) +
-                                              static_cast<diff_type>(knot_ind);
-                            const coord_type x =
-                                spline.range(d).first +
-                                static_cast<coord_type>(i) * base_.dx_[d];
-                            base_spline_vals_per_dim[d] =
-                                spline.base_spline_value(d, iter, x);
-                        }
+            const auto knot_num = spline.knots_num(d);
+            // This is the index of knot point to the left of i-th
+            // interpolated value's coordinate, notice that knot points has
+            // a larger gap in both ends in non-periodic case.
+            size_type knot_ind{};
+            // flag for internal points in uniform aperiodic case
+            const bool is_internal =
+                i > order / 2 &&
+                i < mesh_dimension_.dim_size(d) - order / 2 - 1;
+
+            if (uniform) {
+                knot_ind =
+                    periodic ? i + order
+                             : std::min(knot_num - order - 2,
+                                        i > order / 2 ? i + (order + 1) / 2
+                                                      : order);
+                if (!periodic) {
+                    if (knot_ind <= 2 * order + 1 ||
+                        knot_ind >= knot_num - 2 * order - 2) {
+                        // out of the zone of even-spaced knots, update base
+                        // spline
+                        const auto iter = spline.knots_begin(d) +
+                                          static_cast<diff_type>(knot_ind);
+                        const coord_type x =
+                            spline.range(d).first +
+                            static_cast<coord_type>(i) * base_.dx_[d];
+                        base_spline_vals =
+                            spline.base_spline_value(d, iter, x);
                     }
-                } else {
-                    coord_type x = input_coords_[d][i];
-                    // using BSpline::get_knot_iter to find current
-                    // knot_ind
-                    const auto iter =
-                        periodic ? spline.knots_begin(d) +
-                                       static_cast<diff_type>(i + order)
-                        : i == 0 ? spline.knots_begin(d) +
-                                       static_cast<diff_type>(order)
-                        : i == input_coords_[d].size() - 1
-                            ? spline.knots_end(d) -
-                                  static_cast<diff_type>(order + 2)
-                            : spline.get_knot_iter(
-                                  d, x, i + 1,
-                                  std::min(knot_num - order - 1, i + order));
-                    knot_ind =
-                        static_cast<size_type>(iter - spline.knots_begin(d));
-                    base_spline_vals_per_dim[d] =
-                        spline.base_spline_value(d, iter, x);
                 }
+            } else {
+                coord_type x = input_coords_[d][i];
+                // using BSpline::get_knot_iter to find current
+                // knot_ind
+                const auto iter =
+                    periodic ? spline.knots_begin(d) +
+                                   static_cast<diff_type>(i + order)
+                    : i == 0 ? spline.knots_begin(d) +
+                                   static_cast<diff_type>(order)
+                    : i == input_coords_[d].size() - 1
+                        ? spline.knots_end(d) -
+                              static_cast<diff_type>(order + 2)
+                        : spline.get_knot_iter(
+                              d, x, i + 1,
+                              std::min(knot_num - order - 1, i + order));
+                knot_ind =
+                    static_cast<size_type>(iter - spline.knots_begin(d));
+                base_spline_vals =
+                    spline.base_spline_value(d, iter, x);
+            }
 
-                // number of base spline that covers present data point.
-                const size_type s_num = periodic                 ? order | 1
-                                        : order == 1             ? 1
-                                        : uniform && is_internal ? order | 1
-                                                                 : order + 1;
-                for (size_type j = 0; j < s_num; ++j) {
-                    const size_type row = (i + (periodic ? band_width : 0)) %
-                                          mesh_dimension_.dim_size(d);
-                    const size_type col =
-                        (knot_ind - order + j) % mesh_dimension_.dim_size(d);
+            // number of base spline that covers present data point.
+            const size_type s_num = periodic                 ? order | 1
+                                    : order == 1             ? 1
+                                    : uniform && is_internal ? order | 1
+                                                             : order + 1;
+            for (size_type j = 0; j < s_num; ++j) {
+                const size_type row = (i + (periodic ? band_width : 0)) %
+                                      mesh_dimension_.dim_size(d);
+                const size_type col =
+                    (knot_ind - order + j) % mesh_dimension_.dim_size(d);
 #if __cplusplus >= 201703L
-                    std::visit(
-                        [&](auto& m) {
-                            m(row, col) = base_spline_vals_per_dim[d][j];
-                        },
-                        coef_mat);
+                std::visit(
+                    [&](auto& m) {
+                        m(row, col) = base_spline_vals[j];
+                    },
+                    coef_mat);
 #else
-                    if (periodic) {
-                        coef_mat((i + band_width) % mesh_dimension_.dim_size(d),
-                                 (knot_ind - order + j) %
-                                     mesh_dimension_.dim_size(d)) =
-                            base_spline_vals_per_dim[d][j];
-                    } else {
-                        coef_mat.main_bands_val(i, knot_ind - order + j) =
-                            base_spline_vals_per_dim[d][j];
-                    }
+                if (periodic) {
+                    coef_mat((i + band_width) % mesh_dimension_.dim_size(d),
+                             (knot_ind - order + j) %
+                                 mesh_dimension_.dim_size(d)) =
+                        base_spline_vals[j];
+                } else {
+                    coef_mat.main_bands_val(i, knot_ind - order + j) =
+                        base_spline_vals[j];
+                }
 #endif
 #ifdef _TRACE
-                    std::cout
-                        << "[TRACE] {"
-                        << (periodic
-                                ? (i + band_width) % mesh_dimension_.dim_size(d)
-                                : i)
-                        << ", "
-                        << (knot_ind - order + j) % mesh_dimension_.dim_size(d)
-                        << "} -> " << base_spline_vals_per_dim[d][j] << '\n';
+                std::cout
+                    << "[TRACE] {"
+                    << (periodic
+                            ? (i + band_width) % mesh_dimension_.dim_size(d)
+                            : i)
+                    << ", "
+                    << (knot_ind - order + j) % mesh_dimension_.dim_size(d)
+                    << "} -> " << base_spline_vals[j] << '\n';
 #endif
-                }
             }
+        }
 
 #ifdef _TRACE
-            std::cout << "[TRACE] {" << mesh_dimension_.dim_size(d) - 1 << ", "
-                      << mesh_dimension_.dim_size(d) - 1 << "} -> 1\n";
+        std::cout << "[TRACE] {" << mesh_dimension_.dim_size(d) - 1 << ", "
+                  << mesh_dimension_.dim_size(d) - 1 << "} -> 1\n";
 #endif
 
 #if __cplusplus >= 201703L
+        auto solver = std::make_shared<EitherSolver>();
+        if (use_recursive_filter_(d)) {
+            solver->template emplace<recursive_solver_type>().compute(
+                std::get<typename base_solver_type::matrix_type>(
+                    std::move(coef_mat)));
+        } else {
             std::visit(
-                [&](auto& solver) {
-                    using matrix_t = typename util::remove_cvref_t<
-                        decltype(solver)>::matrix_type;
-                    solver.compute(std::get<matrix_t>(std::move(coef_mat)));
+                [&](auto& m) {
+                    using matrix_t = util::remove_cvref_t<decltype(m)>;
+                    solver->template emplace<BandLU<matrix_t>>().compute(
+                        std::move(m));
                 },
-                solvers_[d]);
+                coef_mat);
+        }
 #else
-            solvers_[d] = periodic;
-            if (periodic) {
-                solvers_[d].solver_periodic.compute(coef_mat);
-            } else {
-                solvers_[d].solver_aperiodic.compute(
-                    static_cast<BandMatrix<val_type>>(coef_mat));
+        using Kind = typename EitherSolver::Kind;
+        std::shared_ptr<EitherSolver> solver;
+        if (use_recursive_filter_(d)) {
+            solver = std::make_shared<EitherSolver>(Kind::recursive);
+            solver->solver_recursive.compute(
+                static_cast<BandMatrix<val_type>>(coef_mat));
+        } else if (circulant) {
+            // the whole matrix is determined by the band of one row
+            typename circulant_solver_type::matrix_type circ_mat(
+                mat_dim, band_width, band_width);
+            for (size_type j = 0; j <= 2 * band_width; ++j) {
+                circ_mat(band_width, j) = coef_mat(band_width, j);
             }
-#endif
+            solver = std::make_shared<EitherSolver>(Kind::circulant);
+            solver->solver_circulant.compute(std::move(circ_mat));
+        } else if (periodic) {
+            solver = std::make_shared<EitherSolver>(Kind::periodic);
+            solver->solver_periodic.compute(coef_mat);
+        } else {
+            solver = std::make_shared<EitherSolver>(Kind::aperiodic);
+            solver->solver_aperiodic.compute(
+                static_cast<BandMatrix<val_type>>(coef_mat));
         }
+#endif
+        return solver;
     }
 
+    static const Mesh<val_type, dim>& input_mesh_(
+        const Mesh<val_type, dim>& mesh) {
+        return mesh;
+    }
+
+    template <typename U>
+    static MeshView<const val_type, dim> input_mesh_(MeshView<U, dim> view) {
+        return view;
+    }
+
+    template <typename MeshOrIterPair,
+              typename Arg = typename std::decay<MeshOrIterPair>::type,
+              typename = typename std::enable_if<
+                  !std::is_same<Arg, Mesh<val_type, dim>>::value &&
+                  !std::is_same<Arg, MeshView<val_type, dim>>::value &&
+                  !std::is_same<Arg, MeshView<const val_type, dim>>::value>::
+                  type>
+    static Mesh<val_type, dim> input_mesh_(MeshOrIterPair&& mesh_or_iter_pair) {
+        return Mesh<val_type, dim>{
+            std::forward<MeshOrIterPair>(mesh_or_iter_pair)};
+    }
+
+    /**
+     * @brief Solve for control points from values on a mesh or a mesh view.
+     *
+     */
+    template <typename MeshLike>
     Mesh<val_type, dim> solve_for_control_points_(
-        const Mesh<val_type, dim>& f_mesh) const {
+        const MeshLike& f_mesh) const {
+        INTP_TIME_SCOPE(solves, solve_ns);
         Mesh<val_type, dim> weights{mesh_dimension_};
 
         auto check_idx =
@@ -417,7 +1110,8 @@ class InterpolationFunctionTemplate {
                 for (size_type d = 0; d < dim; ++d) {
                     if (base_.periodicity(d)) {
                         // Skip last point of periodic dimension
-                        keep_flag = indices[d] != weights.dim_size(d);
+                        keep_flag =
+                            keep_flag && indices[d] != weights.dim_size(d);
                         indices[d] = (indices[d] + weights.dim_size(d) +
                                       base_.order / 2) %
                                      weights.dim_size(d);
@@ -427,51 +1121,227 @@ class InterpolationFunctionTemplate {
             };
 
         // Copy interpolating values into weights mesh as the initial state of
-        // the iterative control points solving algorithm
-        for (auto it = f_mesh.begin(); it != f_mesh.end(); ++it) {
-            auto f_indices = f_mesh.iter_indices(it);
-            if (check_idx(f_indices)) { weights(f_indices) = *it; }
+        // the iterative control points solving algorithm. Values are visited
+        // by index, thus the input mesh can be of any layout. Each hyperplane
+        // of the first dimension is copied on its own.
+        const size_type hyperplane_size = f_mesh.size() / f_mesh.dim_size(0);
+#ifdef INTP_ENABLE_OPENMP
+#pragma omp parallel for
+#endif
+        for (size_type i0 = 0; i0 < f_mesh.dim_size(0); ++i0) {
+            typename Mesh<val_type, dim>::index_type f_indices{};
+            f_indices[0] = i0;
+            for (size_type i = 0; i < hyperplane_size; ++i) {
+                auto w_indices = f_indices;
+                if (check_idx(w_indices)) {
+                    weights(w_indices) = f_mesh(f_indices);
+                }
+
+                // increase index array in row-major order
+                for (size_type d = dim - 1; d > 0; --d) {
+                    if (++f_indices[d] < f_mesh.dim_size(d)) { break; }
+                    f_indices[d] = 0;
+                }
+            }
         }
 
         // loop through each dimension to solve for control points
-        for (size_type d = 0; d < dim; ++d) {
-            // size of hyperplane when given dimension is fixed
-            size_type hyperplane_size = weights.size() / weights.dim_size(d);
+        for (size_type d = 0; d < dim; ++d) { sweep_dimension_(weights, d); }
 
-            // loop over each point (representing a 1D spline) of hyperplane
-            for (size_type i = 0; i < hyperplane_size; ++i) {
-                DimArray<size_type> ind_arr{};
-                for (size_type d_ = 0, total_ind = i; d_ < dim; ++d_) {
-                    if (d_ == d) { continue; }
-                    ind_arr[d_] = total_ind % weights.dim_size(d_);
-                    total_ind /= weights.dim_size(d_);
-                }
+        return weights;
+    }
+
+    /**
+     * @brief Solve the change of control points along dimension d, which
+     * spreads it over the whole dimension, then drop the indices where it is
+     * no larger than tolerance.
+     *
+     * @param change change on the mesh spanned by support
+     * @param support indices spanned by the change in each dimension, the one
+     * of dimension d is updated
+     * @param dropped set to the largest magnitude dropped
+     */
+    Mesh<val_type, dim> spread_change_(
+        const Mesh<val_type, dim>& change,
+        DimArray<std::vector<size_type>>& support,
+        size_type d,
+        val_type tolerance,
+        val_type& dropped) const {
+        const size_type n = mesh_dimension_.dim_size(d);
+        const size_type line_num = change.size() / change.dim_size(d);
 
+        // full lines, one after another
+        std::vector<val_type> lines(line_num * n, val_type{});
+        std::vector<val_type> magnitude(n, val_type{});
+        for (size_type l = 0; l < line_num; ++l) {
+            DimArray<size_type> ind_arr{};
+            for (size_type d_ = 0, total_ind = l; d_ < dim; ++d_) {
+                if (d_ == d) { continue; }
+                ind_arr[d_] = total_ind % change.dim_size(d_);
+                total_ind /= change.dim_size(d_);
+            }
+            const auto line = lines.begin() + static_cast<diff_type>(l * n);
+            auto it = change.begin(d, ind_arr);
+            for (size_type i = 0; i < support[d].size(); ++i, ++it) {
+                line[static_cast<diff_type>(support[d][i])] = *it;
+            }
 #if __cplusplus >= 201703L
-                std::visit(
-                    [&](auto& solver) {
-                        solver.solve(weights.begin(d, ind_arr));
-                    },
-                    solvers_[d]);
+            std::visit([&](auto& solver) { solver.solve(line); },
+                       *solvers_[d]);
 #else
-                // Loop through one dimension, update interpolating value to
-                // control points.
-                // In periodic case, rows are shifted to make coefficient matrix
-                // diagonal dominate so weights column should be shifted
-                // accordingly.
-                // auto iter = weights.begin(d, ind_arr);
-                if (base_.periodicity(d)) {
-                    solvers_[d].solver_periodic.solve(
-                        weights.begin(d, ind_arr));
-                } else {
-                    solvers_[d].solver_aperiodic.solve(
-                        weights.begin(d, ind_arr));
-                }
+            solvers_[d]->solve(line);
 #endif
+            for (size_type i = 0; i < n; ++i) {
+                magnitude[i] = std::max(
+                    magnitude[i], std::abs(line[static_cast<diff_type>(i)]));
             }
         }
 
-        return weights;
+        support[d].clear();
+        dropped = val_type{};
+        for (size_type i = 0; i < n; ++i) {
+            if (tolerance == 0 || magnitude[i] > tolerance) {
+                support[d].push_back(i);
+            } else {
+                dropped = std::max(dropped, magnitude[i]);
+            }
+        }
+
+        DimArray<size_type> sizes;
+        for (size_type d_ = 0; d_ < dim; ++d_) {
+            sizes[d_] = d_ == d ? support[d].size() : change.dim_size(d_);
+        }
+        MeshDim spread_dimension;
+        spread_dimension.resize(sizes);
+        Mesh<val_type, dim> spread{spread_dimension};
+        for (size_type l = 0; l < line_num; ++l) {
+            DimArray<size_type> ind_arr{};
+            for (size_type d_ = 0, total_ind = l; d_ < dim; ++d_) {
+                if (d_ == d) { continue; }
+                ind_arr[d_] = total_ind % change.dim_size(d_);
+                total_ind /= change.dim_size(d_);
+            }
+            const auto line = lines.begin() + static_cast<diff_type>(l * n);
+            auto it = spread.begin(d, ind_arr);
+            for (size_type i = 0; i < support[d].size(); ++i, ++it) {
+                *it = line[static_cast<diff_type>(support[d][i])];
+            }
+        }
+        return spread;
+    }
+
+    /**
+     * @brief Solve along dimension d of weights mesh, every line in place.
+     *
+     */
+    void sweep_dimension_(Mesh<val_type, dim>& weights, size_type d) const {
+        // a mesh fitting in one tile is already cache resident
+        if (sweep_ == SweepStrategy::tiled &&
+            weights.dimension().dim_acc_size(dim - d - 1) > 1 &&
+            weights.size() * sizeof(val_type) > sweep_tile_bytes_) {
+            tiled_sweep_(weights, d);
+            return;
+        }
+
+        // size of hyperplane when given dimension is fixed
+        size_type hyperplane_size = weights.size() / weights.dim_size(d);
+
+        // loop over each point (representing a 1D spline) of hyperplane
+#ifdef INTP_ENABLE_OPENMP
+#pragma omp parallel for
+#endif
+        for (size_type i = 0; i < hyperplane_size; ++i) {
+            DimArray<size_type> ind_arr{};
+            for (size_type d_ = 0, total_ind = i; d_ < dim; ++d_) {
+                if (d_ == d) { continue; }
+                ind_arr[d_] = total_ind % weights.dim_size(d_);
+                total_ind /= weights.dim_size(d_);
+            }
+
+#if __cplusplus >= 201703L
+            std::visit(
+                [&](auto& solver) {
+                    solver.solve(weights.begin(d, ind_arr));
+                },
+                *solvers_[d]);
+#else
+            // Loop through one dimension, update interpolating value to
+            // control points.
+            // In periodic case, rows are shifted to make coefficient matrix
+            // diagonal dominate so weights column should be shifted
+            // accordingly.
+            solvers_[d]->solve(weights.begin(d, ind_arr));
+#endif
+        }
+    }
+
+    /**
+     * @brief Solve along dimension d tile by tile. Lines of dimension d that
+     * differ only in the indices of later dimensions are `stride` apart, thus
+     * a tile of adjacent lines is a block whose rows are contiguous in memory,
+     * solved across the lines at once.
+     *
+     */
+    void tiled_sweep_(Mesh<val_type, dim>& weights, size_type d) const {
+        const size_type n = weights.dim_size(d);
+        const size_type stride = weights.dimension().dim_acc_size(dim - d - 1);
+        const size_type outer_size = weights.size() / (n * stride);
+        const size_type tile = tile_width_(n, stride);
+        const size_type tile_num = (stride + tile - 1) / tile;
+
+        // tiles are disjoint, thus solved independently
+#ifdef INTP_ENABLE_OPENMP
+#pragma omp parallel for
+#endif
+        for (size_type t = 0; t < outer_size * tile_num; ++t) {
+            const size_type j0 = t % tile_num * tile;
+            solve_tile_(weights.data() + t / tile_num * n * stride + j0,
+                        stride, std::min(tile, stride - j0), d);
+        }
+    }
+
+    static void read_values_(std::istream& is, val_type* dst, size_type n) {
+        is.read(reinterpret_cast<char*>(dst),
+                static_cast<std::streamsize>(n * sizeof(val_type)));
+        if (!is) { throw std::runtime_error("Failed to read values."); }
+    }
+
+    static void write_values_(std::ostream& os,
+                              const val_type* src,
+                              size_type n) {
+        os.write(reinterpret_cast<const char*>(src),
+                 static_cast<std::streamsize>(n * sizeof(val_type)));
+        if (!os) { throw std::runtime_error("Failed to write values."); }
+    }
+
+    /**
+     * @brief Number of lines of length n in a tile, at most `max_width`.
+     *
+     */
+    size_type tile_width_(size_type n, size_type max_width) const {
+        const size_type width = sweep_tile_bytes_ / (n * sizeof(val_type));
+        return std::min(max_width, std::max(size_type{1}, width));
+    }
+
+    /**
+     * @brief Solve a tile of `width` adjacent lines along dimension d. The
+     * i-th points of the lines are contiguous, starting from `block + i *
+     * pitch`.
+     *
+     */
+    void solve_tile_(val_type* block,
+                     size_type pitch,
+                     size_type width,
+                     size_type d) const {
+#if __cplusplus >= 201703L
+        std::visit(
+            [&](auto& solver) {
+                solver.solve_block_in_place(block, pitch, width);
+            },
+            *solvers_[d]);
+#else
+        solvers_[d]->solve_block_in_place(block, pitch, width);
+#endif
     }
 };
 
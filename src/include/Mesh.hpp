@@ -1,13 +1,23 @@
 #ifndef INTP_MESH
 #define INTP_MESH
 
+#include <algorithm>
 #include <array>
+#include <type_traits>
 #include <vector>
 
 #include "util.hpp"
 
 namespace intp {
 
+/**
+ * @brief Memory layout of a mesh. `row_major` stores the last index
+ * contiguously (C order), `col_major` stores the first index contiguously
+ * (Fortran/MATLAB order), and `strided` takes arbitrary strides given by user.
+ *
+ */
+enum class Layout { row_major, col_major, strided };
+
 template <size_t D>
 class MeshDimension {
    public:
@@ -23,6 +33,18 @@ class MeshDimension {
      */
     std::array<size_type, dim + 1> dim_acc_size_;
 
+    Layout layout_ = Layout::row_major;
+    /**
+     * @brief Distance in storage between adjacent points along each
+     * dimension.
+     */
+    index_type strides_;
+    /**
+     * @brief Dimensions sorted by descending stride, used to decompose a
+     * storage index.
+     */
+    index_type stride_order_;
+
     /**
      * @brief Set the dim_acc_size_ object. Check description of dim_acc_size_
      * for details.
@@ -36,17 +58,60 @@ class MeshDimension {
         }
     }
 
+    /**
+     * @brief Set strides according to layout, except for strided layout whose
+     * strides are given by user.
+     */
+    void set_strides() {
+        size_type acc = 1;
+        for (size_type i = 0; i < dim; ++i) {
+            const size_type d = layout_ == Layout::col_major ? i : dim - i - 1;
+            if (layout_ != Layout::strided) { strides_[d] = acc; }
+            acc *= dim_size_[d];
+        }
+        for (size_type d = 0; d < dim; ++d) { stride_order_[d] = d; }
+        std::stable_sort(stride_order_.begin(), stride_order_.end(),
+                         [&](size_type d1, size_type d2) {
+                             return strides_[d1] > strides_[d2];
+                         });
+    }
+
    public:
     MeshDimension() = default;
 
     MeshDimension(std::initializer_list<size_type> il) {
         std::copy(il.begin(), il.end(), dim_size_.begin());
         set_dim_acc_size();
+        set_strides();
     }
 
     MeshDimension(size_type n) {
         std::fill(dim_size_.begin(), dim_size_.end(), n);
         set_dim_acc_size();
+        set_strides();
+    }
+
+    /**
+     * @brief Construct a dense mesh dimension of given layout.
+     *
+     */
+    MeshDimension(index_type sizes, Layout layout)
+        : dim_size_(sizes), layout_(layout) {
+        if (layout_ == Layout::strided) { layout_ = Layout::row_major; }
+        set_dim_acc_size();
+        set_strides();
+    }
+
+    /**
+     * @brief Construct a mesh dimension with arbitrary strides (in number of
+     * elements), e.g. of a sub-array or of an array with padding. Strides
+     * should not map different indices to the same storage.
+     *
+     */
+    MeshDimension(index_type sizes, index_type strides)
+        : dim_size_(sizes), layout_(Layout::strided), strides_(strides) {
+        set_dim_acc_size();
+        set_strides();
     }
 
     // properties
@@ -59,6 +124,24 @@ class MeshDimension {
         return dim_acc_size_[dim_ind];
     }
 
+    Layout layout() const { return layout_; }
+
+    size_type stride(size_type dim_ind) const { return strides_[dim_ind]; }
+
+    /**
+     * @brief Length of storage spanned by the mesh, which equals size()
+     * unless strides leave gaps.
+     *
+     */
+    size_type extent() const {
+        if (size() == 0) { return 0; }
+        size_type ext = 1;
+        for (size_type d = 0; d < dim; ++d) {
+            ext += (dim_size_[d] - 1) * strides_[d];
+        }
+        return ext;
+    }
+
     /**
      * @brief Convert multi-dimension index to one dimension index in storage
      * vector.
@@ -67,7 +150,8 @@ class MeshDimension {
      */
     template <typename T, typename... Indices>
     size_type indexing(T ind, Indices... indices) const {
-        return static_cast<size_type>(ind) * dim_acc_size_[sizeof...(indices)] +
+        return static_cast<size_type>(ind) *
+                   strides_[dim - sizeof...(indices) - 1] +
                indexing(indices...);
     }
 
@@ -75,9 +159,7 @@ class MeshDimension {
 
     size_type indexing(index_type ind_arr) const {
         size_type ind{};
-        for (size_type d = 0; d < dim; ++d) {
-            ind += ind_arr[d] * dim_acc_size_[dim - d - 1];
-        }
+        for (size_type d = 0; d < dim; ++d) { ind += ind_arr[d] * strides_[d]; }
         return ind;
     }
 
@@ -87,11 +169,13 @@ class MeshDimension {
      *
      */
     index_type dimwise_indices(size_type total_ind) const {
-        index_type indices;
+        index_type indices{};
 
-        for (size_type d = 0; d < dim; ++d) {
-            indices[d] = total_ind / dim_acc_size_[dim - d - 1];
-            total_ind %= dim_acc_size_[dim - d - 1];
+        for (auto d : stride_order_) {
+            // stride of dimension of size 1 is meaningless
+            if (dim_size_[d] <= 1) { continue; }
+            indices[d] = total_ind / strides_[d];
+            total_ind %= strides_[d];
         }
 
         return indices;
@@ -99,12 +183,23 @@ class MeshDimension {
 
     // modifiers
 
+    /**
+     * @brief Change sizes of each dimension. Dense layouts are kept, while
+     * strided layout is reset to row-major since the given strides no longer
+     * apply.
+     *
+     */
     void resize(index_type sizes) {
         dim_size_ = sizes;
+        if (layout_ == Layout::strided) { layout_ = Layout::row_major; }
         set_dim_acc_size();
+        set_strides();
     }
 };
 
+template <typename T, size_t D>
+class MeshView;
+
 /**
  * @brief A multi dimension mesh storing data on each mesh point
  *
@@ -222,7 +317,8 @@ class Mesh {
     };
 
     /**
-     * @brief Stores the mesh content in row-major format.
+     * @brief Stores the mesh content in the layout of mesh dimension,
+     * defaulted to row-major.
      */
     container_type storage_;
 
@@ -231,7 +327,7 @@ class Mesh {
    public:
     explicit Mesh(const MeshDimension<dim>& mesh_dimension)
         : dimension_(mesh_dimension) {
-        storage_.resize(dimension_.size(), val_type{});
+        storage_.resize(dimension_.extent(), val_type{});
     }
 
     explicit Mesh(std::initializer_list<size_type> il,
@@ -245,6 +341,34 @@ class Mesh {
         storage_.resize(dimension_.size(), val_type{});
     }
 
+    /**
+     * @brief Copy the data of a mesh view into a row-major mesh.
+     *
+     */
+    template <typename U,
+              typename = typename std::enable_if<std::is_same<
+                  typename std::remove_const<U>::type,
+                  val_type>::value>::type>
+    explicit Mesh(const MeshView<U, dim>& view,
+                  const allocator_type& alloc = allocator_type())
+        : storage_(alloc) {
+        index_type sizes;
+        for (size_type d = 0; d < dim; ++d) { sizes[d] = view.dim_size(d); }
+        dimension_.resize(sizes);
+        storage_.reserve(dimension_.size());
+
+        index_type indices{};
+        for (size_type i = 0; i < dimension_.size(); ++i) {
+            storage_.push_back(view(indices));
+
+            // increase index array in row-major order
+            for (size_type d = dim - 1; d < dim; --d) {
+                if (++indices[d] < sizes[d]) { break; }
+                indices[d] = 0;
+            }
+        }
+    }
+
     template <typename InputIter,
               typename = typename std::enable_if<
                   dim == 1u &&
@@ -266,7 +390,7 @@ class Mesh {
    public:
     // properties
 
-    size_type size() const { return storage_.size(); }
+    size_type size() const { return dimension_.size(); }
 
     size_type dim_size(size_type dim_ind) const {
         return dimension_.dim_size(dim_ind);
@@ -282,7 +406,7 @@ class Mesh {
 
     void resize(index_type sizes) {
         dimension_.resize(sizes);
-        storage_.resize(dimension_.size());
+        storage_.resize(dimension_.extent());
     }
 
     // element access
@@ -297,12 +421,28 @@ class Mesh {
         return storage_[dimension_.indexing(indices...)];
     }
 
+    val_type* data() { return storage_.data(); }
+
     const val_type* data() const { return storage_.data(); }
 
+    /**
+     * @brief Hint the processor to fetch the element into cache, without
+     * waiting for it.
+     *
+     */
+    void prefetch(const index_type& indices) const {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(storage_.data() + dimension_.indexing(indices));
+#else
+        static_cast<void>(indices);
+#endif
+    }
+
     // iterator
 
     /**
-     * @brief Begin const_iterator to underlying container.
+     * @brief Begin const_iterator to underlying container, which traverses
+     * the mesh in storage order.
      *
      * @return iterator
      */
@@ -319,14 +459,14 @@ class Mesh {
         return skip_iterator<val_type>(
             storage_.data() + dimension_.indexing(indices),
             static_cast<typename skip_iterator<val_type>::difference_type>(
-                dimension_.dim_acc_size(dim - dim_ind - 1)));
+                dimension_.stride(dim_ind)));
     }
     skip_iterator<val_type> end(size_type dim_ind, index_type indices) {
         indices[dim_ind] = dimension_.dim_size(dim_ind);
         return skip_iterator<val_type>(
             storage_.data() + dimension_.indexing(indices),
             static_cast<typename skip_iterator<val_type>::difference_type>(
-                dimension_.dim_acc_size(dim - dim_ind - 1)));
+                dimension_.stride(dim_ind)));
     }
     skip_iterator<const val_type> begin(size_type dim_ind,
                                         index_type indices) const {
@@ -334,14 +474,15 @@ class Mesh {
         return skip_iterator<const val_type>(
             storage_.data() + dimension_.indexing(indices),
             static_cast<typename skip_iterator<val_type>::difference_type>(
-                dimension_.dim_acc_size(dim - dim_ind - 1)));
+                dimension_.stride(dim_ind)));
     }
     skip_iterator<const val_type> end(size_type dim_ind,
                                       index_type indices) const {
         indices[dim_ind] = dimension_.dim_size(dim_ind);
         return skip_iterator<const val_type>(
-            storage_.data() + indexing(indices),
-            dimension_.dim_acc_size(dim - dim_ind - 1));
+            storage_.data() + dimension_.indexing(indices),
+            static_cast<typename skip_iterator<val_type>::difference_type>(
+                dimension_.stride(dim_ind)));
     }
 
     index_type iter_indices(const_iterator iter) const {
@@ -350,6 +491,92 @@ class Mesh {
     }
 };
 
+/**
+ * @brief A non-owning view of multi dimension data in external storage (e.g.
+ * arrays of a solver or of another language), in the layout given by its
+ * mesh dimension. The storage should outlive the view.
+ *
+ * @tparam T Type of data viewed, const qualified for a read-only view
+ * @tparam D Dimension
+ */
+template <typename T, size_t D>
+class MeshView {
+   public:
+    using size_type = size_t;
+    using val_type = T;
+    const static size_type dim = D;
+    using index_type = typename MeshDimension<dim>::index_type;
+
+   private:
+    using nonconst_type = typename std::remove_const<val_type>::type;
+
+    val_type* data_;
+    MeshDimension<dim> dimension_;
+
+   public:
+    MeshView(val_type* data, const MeshDimension<dim>& mesh_dimension)
+        : data_(data), dimension_(mesh_dimension) {}
+
+    /**
+     * @brief Construct a dense view, in row-major order by default.
+     *
+     */
+    MeshView(val_type* data,
+             index_type sizes,
+             Layout layout = Layout::row_major)
+        : MeshView(data, MeshDimension<dim>(sizes, layout)) {}
+
+    template <typename Alloc>
+    MeshView(Mesh<nonconst_type, dim, Alloc>& mesh)
+        : MeshView(mesh.data(), mesh.dimension()) {}
+
+    template <typename Alloc,
+              typename U = val_type,
+              typename = typename std::enable_if<std::is_const<U>::value>::type>
+    MeshView(const Mesh<nonconst_type, dim, Alloc>& mesh)
+        : MeshView(mesh.data(), mesh.dimension()) {}
+
+    // allow view to const view conversion
+    template <typename U,
+              typename = typename std::enable_if<
+                  std::is_const<val_type>::value &&
+                  std::is_same<const U, val_type>::value>::type>
+    MeshView(const MeshView<U, dim>& other)
+        : MeshView(other.data(), other.dimension()) {}
+
+    // properties
+
+    size_type size() const { return dimension_.size(); }
+
+    size_type dim_size(size_type dim_ind) const {
+        return dimension_.dim_size(dim_ind);
+    }
+
+    const MeshDimension<dim>& dimension() const { return dimension_; }
+
+    // element access
+
+    template <typename... Indices>
+    val_type& operator()(Indices... indices) const {
+        return data_[dimension_.indexing(indices...)];
+    }
+
+    val_type* data() const { return data_; }
+
+    /**
+     * @brief Hint the processor to fetch the element into cache, without
+     * waiting for it.
+     *
+     */
+    void prefetch(const index_type& indices) const {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(data_ + dimension_.indexing(indices));
+#else
+        static_cast<void>(indices);
+#endif
+    }
+};
+
 }  // namespace intp
 
 #endif
@@ -0,0 +1,318 @@
+#ifndef INTP_PIECEWISE_POLYNOMIAL
+#define INTP_PIECEWISE_POLYNOMIAL
+
+#include <algorithm>  // upper_bound
+#include <array>
+#include <cmath>      // floor, fmod
+#include <stdexcept>  // domain_error
+#include <vector>
+
+#include "BSpline.hpp"
+
+namespace intp {
+
+/**
+ * @brief Piecewise polynomial (pp-form) representation of a B-spline. Each
+ * cell stores (order+1)^dim coefficients of a tensor product polynomial in
+ * power basis contiguously, so that evaluation is one cell lookup plus a Horner
+ * contraction over a single block. It takes more memory than B-spline, but
+ * there is no Cox-de Boor recursion at evaluation.
+ *
+ * @tparam T Type of function value
+ * @tparam D Dimension
+ */
+template <typename T, size_t D>
+class PiecewisePolynomial {
+   public:
+    using size_type = size_t;
+    using val_type = T;
+    using spline_type = BSpline<T, D>;
+    using knot_type = typename spline_type::knot_type;
+
+    const static size_type dim = D;
+
+   private:
+    template <typename T_>
+    using DimArray = std::array<T_, dim>;
+
+    DimArray<size_type> orders_;
+    DimArray<bool> periodicity_;
+    // cell boundaries of each dimension
+    DimArray<std::vector<knot_type>> breaks_;
+    // inverse of cell width if interior cells are evenly spaced, otherwise 0
+    DimArray<knot_type> inv_dx_;
+
+    // strides of each dimension inside one block of coefficients
+    DimArray<size_type> block_strides_;
+    size_type block_size_;
+    // strides of each dimension in cell indexing
+    DimArray<size_type> cell_strides_;
+
+    std::vector<val_type> coefs_;
+
+    // auxiliary methods
+
+    /**
+     * @brief Find the cell where x locates in one dimension. Coordinate out of
+     * range is wrapped in periodic dimension, or put in the boundary cell
+     * otherwise.
+     *
+     * @param dim_ind dimension index
+     * @param x coordinate, wrapped if dimension is periodic
+     */
+    inline size_type cell_index_(size_type dim_ind, knot_type& x) const {
+        const auto& b = breaks_[dim_ind];
+        if (periodicity_[dim_ind]) {
+            const knot_type period = b.back() - b.front();
+            x = b.front() + (x < b.front()
+                                 ? std::fmod(x - b.front(), period) + period
+                                 : std::fmod(x - b.front(), period));
+        }
+        const size_type cells = b.size() - 1;
+        if (inv_dx_[dim_ind] > 0) {
+            const knot_type guess =
+                std::floor((x - b[cells > 1 ? 1 : 0]) * inv_dx_[dim_ind]) + 1;
+            const size_type c =
+                guess <= 0 ? 0
+                           : std::min(cells - 1, static_cast<size_type>(guess));
+            if ((c == 0 || b[c] <= x) && (c + 1 == cells || x < b[c + 1])) {
+                return c;
+            }
+        }
+        return static_cast<size_type>(
+                   std::upper_bound(b.begin() + 1, b.end() - 1, x) -
+                   b.begin()) -
+               1;
+    }
+
+    /**
+     * @brief Horner's method on a block of coefficients, from dimension d
+     * onward.
+     *
+     */
+    template <size_type d>
+    inline typename std::enable_if<(d + 1 < dim), val_type>::type horner_(
+        const val_type* block,
+        const DimArray<knot_type>& u) const {
+        const size_type stride = block_strides_[d];
+        const val_type* p = block + orders_[d] * stride;
+        val_type v = horner_<d + 1>(p, u);
+        for (size_type m = orders_[d]; m-- > 0;) {
+            p -= stride;
+            v = v * u[d] + horner_<d + 1>(p, u);
+        }
+        return v;
+    }
+
+    template <size_type d>
+    inline typename std::enable_if<(d + 1 == dim), val_type>::type horner_(
+        const val_type* block,
+        const DimArray<knot_type>& u) const {
+        val_type v = block[orders_[d]];
+        for (size_type m = orders_[d]; m-- > 0;) { v = v * u[d] + block[m]; }
+        return v;
+    }
+
+   public:
+    /**
+     * @brief Construct pp-form from a B-spline. Conversion is exact (up to
+     * round-off error).
+     *
+     * @param spline a B-spline
+     */
+    explicit PiecewisePolynomial(const spline_type& spline) : block_size_(1) {
+        // knot index of the left end of each cell
+        DimArray<std::vector<size_type>> segs;
+        // Each cell has a (order+1)x(order+1) matrix converting its control
+        // points to power basis coefficients.
+        DimArray<std::vector<std::vector<knot_type>>> transforms;
+
+        for (size_type d = 0; d < dim; ++d) {
+            const size_type o = spline.dim_order(d);
+            const size_type n = spline.control_points_.dim_size(d);
+            const auto& t = spline.knots_[d];
+            orders_[d] = o;
+            periodicity_[d] = spline.periodicity(d);
+
+            const size_type seg_end = o + (periodicity_[d] ? n : n - o);
+            for (size_type s = o; s < seg_end; ++s) {
+                if (t[s + 1] <= t[s]) { continue; }
+                breaks_[d].push_back(t[s]);
+                segs[d].push_back(s);
+
+                std::vector<knot_type> mat((o + 1) * (o + 1));
+                std::vector<knot_type> local(o + 1), col;
+                for (size_type j = 0; j <= o; ++j) {
+                    std::fill(local.begin(), local.end(), knot_type{});
+                    local[j] = 1;
+                    spline.to_power_basis_(d, s, local, col);
+                    for (size_type m = 0; m <= o; ++m) {
+                        mat[m * (o + 1) + j] = col[m];
+                    }
+                }
+                transforms[d].push_back(std::move(mat));
+            }
+            breaks_[d].push_back(t[seg_end]);
+
+            // check whether interior cells are evenly spaced
+            const auto& b = breaks_[d];
+            const size_type cells = b.size() - 1;
+            inv_dx_[d] = 1 / (b.back() - b.front());
+            if (cells > 2) {
+                const knot_type dx = (b[cells - 1] - b[1]) /
+                                     static_cast<knot_type>(cells - 2);
+                for (size_type i = 1; i < cells - 1; ++i) {
+                    if (std::abs(b[i + 1] - b[i] - dx) > 1e-8 * dx) {
+                        inv_dx_[d] = 0;
+                        break;
+                    }
+                }
+                if (inv_dx_[d] != 0) { inv_dx_[d] = 1 / dx; }
+            }
+        }
+
+        size_type cells_num = 1;
+        for (size_type d = dim; d-- > 0;) {
+            block_strides_[d] = block_size_;
+            block_size_ *= orders_[d] + 1;
+            cell_strides_[d] = cells_num;
+            cells_num *= breaks_[d].size() - 1;
+        }
+        coefs_.resize(cells_num * block_size_);
+
+        std::vector<val_type> buf(block_size_), tmp(block_size_);
+        for (size_type ci = 0; ci < cells_num; ++ci) {
+            DimArray<size_type> cell;
+            for (size_type d = 0; d < dim; ++d) {
+                cell[d] = ci / cell_strides_[d] % (breaks_[d].size() - 1);
+            }
+
+            // gather control points of this cell
+            for (size_type bi = 0; bi < block_size_; ++bi) {
+                DimArray<size_type> ind;
+                for (size_type d = 0; d < dim; ++d) {
+                    const size_type j =
+                        bi / block_strides_[d] % (orders_[d] + 1);
+                    ind[d] = (segs[d][cell[d]] - orders_[d] + j) %
+                             spline.control_points_.dim_size(d);
+                }
+                buf[bi] = spline.control_points_(ind);
+            }
+
+            // Apply conversion matrix dimension by dimension. The block is
+            // viewed as a 3D array of shape (outer, order+1, inner).
+            for (size_type d = 0; d < dim; ++d) {
+                const size_type w = orders_[d] + 1;
+                const size_type inner = block_strides_[d];
+                const size_type outer = block_size_ / (w * inner);
+                const auto& mat = transforms[d][cell[d]];
+                for (size_type o = 0; o < outer; ++o) {
+                    for (size_type m = 0; m < w; ++m) {
+                        for (size_type i = 0; i < inner; ++i) {
+                            val_type v{};
+                            for (size_type j = 0; j < w; ++j) {
+                                v += mat[m * w + j] *
+                                     buf[(o * w + j) * inner + i];
+                            }
+                            tmp[(o * w + m) * inner + i] = v;
+                        }
+                    }
+                }
+                std::swap(buf, tmp);
+            }
+
+            std::copy(buf.begin(), buf.end(),
+                      coefs_.begin() +
+                          static_cast<std::ptrdiff_t>(ci * block_size_));
+        }
+    }
+
+    /**
+     * @brief Get function value. Coordinates out of range in aperiodic
+     * dimension are extrapolated by polynomial of boundary cell.
+     *
+     * @param coord coordinate array
+     */
+    val_type operator()(DimArray<knot_type> coord) const {
+        size_type offset = 0;
+        for (size_type d = 0; d < dim; ++d) {
+            const size_type c = cell_index_(d, coord[d]);
+            offset += c * cell_strides_[d];
+            coord[d] -= breaks_[d][c];
+        }
+        return horner_<0>(coefs_.data() + offset * block_size_, coord);
+    }
+
+    /**
+     * @brief Get function value.
+     *
+     * @param x coordinates
+     */
+    template <typename... Coords,
+              typename = typename std::enable_if<
+                  sizeof...(Coords) == dim &&
+                  std::is_arithmetic<typename std::common_type<
+                      Coords...>::type>::value>::type>
+    val_type operator()(Coords... x) const {
+        return (*this)(DimArray<knot_type>{static_cast<knot_type>(x)...});
+    }
+
+    /**
+     * @brief Get function value, but with out of boundary check.
+     *
+     * @param coord coordinate array
+     */
+    val_type at(DimArray<knot_type> coord) const {
+        for (size_type d = 0; d < dim; ++d) {
+            if (!periodicity_[d] &&
+                (coord[d] < range(d).first || coord[d] > range(d).second)) {
+                throw std::domain_error(
+                    "Given coordinate out of interpolation function range!");
+            }
+        }
+        return (*this)(coord);
+    }
+
+    /**
+     * @brief Get function value, but with out of boundary check.
+     *
+     * @param x coordinates
+     */
+    template <typename... Coords,
+              typename = typename std::enable_if<
+                  sizeof...(Coords) == dim &&
+                  std::is_arithmetic<typename std::common_type<
+                      Coords...>::type>::value>::type>
+    val_type at(Coords... x) const {
+        return at(DimArray<knot_type>{static_cast<knot_type>(x)...});
+    }
+
+    // properties
+
+    std::pair<knot_type, knot_type> range(size_type dim_ind) const {
+        return std::make_pair(breaks_[dim_ind].front(),
+                              breaks_[dim_ind].back());
+    }
+
+    bool periodicity(size_type dim_ind) const {
+        return periodicity_[dim_ind];
+    }
+
+    /**
+     * @brief Get polynomial order of one dimension
+     *
+     */
+    size_type dim_order(size_type dim_ind) const { return orders_[dim_ind]; }
+
+    /**
+     * @brief Get number of cells of one dimension
+     *
+     */
+    size_type cells_num(size_type dim_ind) const {
+        return breaks_[dim_ind].size() - 1;
+    }
+};
+
+}  // namespace intp
+
+#endif
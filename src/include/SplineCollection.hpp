@@ -0,0 +1,395 @@
+#ifndef INTP_SPLINE_COLLECTION
+#define INTP_SPLINE_COLLECTION
+
+#include <algorithm>  // copy
+#include <array>
+#include <iterator>   // distance
+#include <stdexcept>  // range_error, domain_error
+#include <type_traits>
+#include <utility>  // move
+#include <vector>
+
+#include "InterpolationTemplate.hpp"
+#include "Mesh.hpp"
+
+namespace intp {
+
+/**
+ * @brief Storage of control points of a spline collection.
+ *
+ */
+enum class CollectionLayout {
+    planar,      ///< control points of each function in a separate plane
+    interleaved  ///< control points of all functions adjacent per grid point
+};
+
+/**
+ * @brief A collection of spline functions on one grid, i.e. sharing knots,
+ * orders and periodicity. The grid is stored once, and the control points of
+ * all functions are stored either in separate planes or interleaved per grid
+ * point. Any subset of functions can be evaluated at a point with one knot
+ * lookup and base spline computation.
+ *
+ * @tparam T Type of control point
+ * @tparam D Dimension
+ */
+template <typename T, size_t D>
+class SplineCollection {
+   public:
+    using function_type = InterpolationFunction<T, D>;
+    using spline_type = typename function_type::spline_type;
+    using val_type = T;
+    using size_type = typename function_type::size_type;
+    using coord_type = typename function_type::coord_type;
+
+    const static size_type dim = D;
+
+    template <typename U>
+    using DimArray = std::array<U, dim>;
+
+    /**
+     * @brief Control points of all functions, indexed by function index
+     * followed by control point indices.
+     */
+    using ControlPointContainer = Mesh<val_type, dim + 1>;
+
+   private:
+    // a function on the grid, with control points dropped
+    function_type geometry_;
+    CollectionLayout layout_;
+    ControlPointContainer control_points_;
+
+    /**
+     * @brief Control points involved in evaluation at one point, and base
+     * spline values multiplied to them.
+     */
+    struct Stencil {
+        DimArray<typename spline_type::BaseSpline> base_values;
+        DimArray<size_type> begin;
+    };
+
+    Stencil locate_(DimArray<coord_type> coord) const {
+        const auto& spline = geometry_.spline_;
+        Stencil stencil;
+        for (size_type d = 0; d < dim; ++d) {
+            const size_type hint = geometry_.knot_hint_(d, coord[d]);
+            const auto iter = spline.get_knot_iter(d, coord[d], hint);
+            stencil.base_values[d] =
+                spline.base_spline_value(d, iter, coord[d]);
+            stencil.begin[d] =
+                static_cast<size_type>(
+                    std::distance(spline.knots_begin(d), iter)) -
+                spline.dim_order(d);
+        }
+        return stencil;
+    }
+
+    /**
+     * @brief Collect base spline products and storage offsets (relative to
+     * the first function) of control points involved in a stencil.
+     *
+     */
+    const std::vector<std::pair<val_type, size_type>>& weights_(
+        const Stencil& stencil) const {
+        const auto& spline = geometry_.spline_;
+        const auto& ctrl_dim = control_points_.dimension();
+        size_type stencil_size = 1;
+        for (size_type d = 0; d < dim; ++d) {
+            stencil_size *= spline.dim_order(d) + 1;
+        }
+
+        // reused among evaluations, one per thread
+        thread_local std::vector<std::pair<val_type, size_type>> weights;
+        weights.resize(stencil_size);
+        for (size_type i = 0; i < stencil_size; ++i) {
+            val_type coef = 1;
+            size_type offset = 0;
+            for (size_type d = 0, combined_ind = i; d < dim; ++d) {
+                const size_type o = spline.dim_order(d);
+                const size_type j = combined_ind % (o + 1);
+                combined_ind /= o + 1;
+                // base spline values are aligned at right
+                coef *= stencil.base_values[d][spline.order - o + j];
+                size_type ind = stencil.begin[d] + j;
+                if (spline.periodicity(d)) {
+                    ind %= control_points_.dim_size(d + 1);
+                }
+                offset += ind * ctrl_dim.stride(d + 1);
+            }
+            weights[i] = {coef, offset};
+        }
+        return weights;
+    }
+
+    val_type value_at_(
+        const std::vector<std::pair<val_type, size_type>>& weights,
+        size_type func_ind) const {
+        const val_type* ctrl_pts =
+            control_points_.data() +
+            func_ind * control_points_.dimension().stride(0);
+        val_type v{};
+        for (const auto& w : weights) { v += w.first * ctrl_pts[w.second]; }
+        return v;
+    }
+
+    static MeshDimension<dim + 1> storage_dimension_(
+        typename ControlPointContainer::index_type sizes,
+        CollectionLayout layout) {
+        if (layout == CollectionLayout::planar) {
+            return {sizes, Layout::row_major};
+        }
+        // function index varies fastest, followed by row-major grid indices
+        typename ControlPointContainer::index_type strides;
+        strides[0] = 1;
+        size_type acc = sizes[0];
+        for (size_type d = dim; d > 0; --d) {
+            strides[d] = acc;
+            acc *= sizes[d];
+        }
+        return {sizes, strides};
+    }
+
+    /**
+     * @brief Copy control points of one function into its plane.
+     *
+     */
+    template <typename MeshLike>
+    void load_function_(size_type func_ind, const MeshLike& ctrl_pts) {
+        typename ControlPointContainer::index_type ind{};
+        typename Mesh<val_type, dim>::index_type plane_ind{};
+        ind[0] = func_ind;
+        const size_type plane_size = ctrl_pts.size();
+        for (size_type i = 0; i < plane_size; ++i) {
+            control_points_(ind) = ctrl_pts(plane_ind);
+            // row-major odometer over grid indices
+            for (size_type d = dim; d > 0; --d) {
+                ind[d] = ++plane_ind[d - 1];
+                if (ind[d] < control_points_.dim_size(d)) { break; }
+                ind[d] = plane_ind[d - 1] = 0;
+            }
+        }
+    }
+
+    /**
+     * @brief Sizes of control points of func_num functions on the grid of
+     * geometry_, which still holds its own control points.
+     *
+     */
+    typename ControlPointContainer::index_type plane_sizes_(
+        size_type func_num) const {
+        typename ControlPointContainer::index_type sizes;
+        sizes[0] = func_num;
+        for (size_type d = 0; d < dim; ++d) {
+            sizes[d + 1] = geometry_.spline_.control_points_.dim_size(d);
+        }
+        return sizes;
+    }
+
+    void check_control_points_() const {
+        const auto& spline = geometry_.spline_;
+        for (size_type d = 0; d < dim; ++d) {
+            if (spline.knots_num(d) - control_points_.dim_size(d + 1) !=
+                (spline.periodicity(d)
+                     // periodic knots of even order carry one extra knot
+                     ? 2 * spline.dim_order(d) + 1 +
+                           (1 - spline.dim_order(d) % 2)
+                     : spline.dim_order(d) + 1)) {
+                throw std::range_error(
+                    "Inconsistency between knot number and control point "
+                    "number.");
+            }
+        }
+    }
+
+   public:
+    /**
+     * @brief Construct a new Spline Collection object
+     *
+     * @param geometry a function on the grid shared by the collection, whose
+     * own control points are not used
+     * @param control_points control points of all functions, the first index
+     * being function index, in any layout
+     * @param layout storage of control points in the collection
+     */
+    SplineCollection(function_type geometry,
+                     ControlPointContainer control_points,
+                     CollectionLayout layout = CollectionLayout::planar)
+        : geometry_(std::move(geometry)),
+          layout_(layout),
+          control_points_(std::move(control_points)) {
+        check_control_points_();
+        typename ControlPointContainer::index_type sizes;
+        for (size_type d = 0; d <= dim; ++d) {
+            sizes[d] = control_points_.dim_size(d);
+        }
+        const auto storage_dim = storage_dimension_(sizes, layout_);
+        bool same_storage = true;
+        for (size_type d = 0; d <= dim; ++d) {
+            same_storage = same_storage && (sizes[d] == 1 ||
+                                            storage_dim.stride(d) ==
+                                                control_points_.dimension()
+                                                    .stride(d));
+        }
+        if (!same_storage) {
+            ControlPointContainer given(std::move(control_points_));
+            control_points_ = ControlPointContainer(storage_dim);
+            for (size_type k = 0; k < sizes[0]; ++k) {
+                typename Mesh<val_type, dim>::index_type plane_sizes, strides;
+                for (size_type d = 0; d < dim; ++d) {
+                    plane_sizes[d] = sizes[d + 1];
+                    strides[d] = given.dimension().stride(d + 1);
+                }
+                load_function_(
+                    k, MeshView<const val_type, dim>(
+                           given.data() + k * given.dimension().stride(0),
+                           MeshDimension<dim>(plane_sizes, strides)));
+            }
+        }
+        geometry_.spline_.load_ctrlPts(
+            typename spline_type::ControlPointContainer(size_type{}));
+    }
+
+    /**
+     * @brief Fit functions on one grid and collect them.
+     *
+     * @param interp_template template of the grid
+     * @param first, last range of meshes (or mesh views) of function values
+     * @param layout storage of control points in the collection
+     */
+    template <typename ForwardIter>
+    SplineCollection(
+        const InterpolationFunctionTemplate<val_type, dim>& interp_template,
+        ForwardIter first,
+        ForwardIter last,
+        CollectionLayout layout = CollectionLayout::planar)
+        : geometry_(first != last
+                        ? interp_template.interpolate(*first)
+                        : throw std::domain_error(
+                              "No function is given to spline collection.")),
+          layout_(layout),
+          control_points_(storage_dimension_(
+              plane_sizes_(static_cast<size_type>(std::distance(first, last))),
+              layout)) {
+        load_function_(0, geometry_.spline_.control_points_);
+        size_type k = 1;
+        for (++first; first != last; ++first, ++k) {
+            load_function_(
+                k, interp_template.interpolate(*first).spline_.control_points_);
+        }
+        geometry_.spline_.load_ctrlPts(
+            typename spline_type::ControlPointContainer(size_type{}));
+    }
+
+    // properties
+
+    /**
+     * @brief Number of functions in the collection.
+     *
+     */
+    size_type size() const { return control_points_.dim_size(0); }
+
+    CollectionLayout layout() const { return layout_; }
+
+    /**
+     * @brief Get the function providing grid of the collection, without
+     * control points.
+     *
+     */
+    const function_type& geometry() const { return geometry_; }
+
+    const ControlPointContainer& control_points() const {
+        return control_points_;
+    }
+
+    /**
+     * @brief Get a standalone copy of the func_ind-th function.
+     *
+     */
+    function_type function(size_type func_ind) const {
+        typename Mesh<val_type, dim>::index_type sizes, strides;
+        for (size_type d = 0; d < dim; ++d) {
+            sizes[d] = control_points_.dim_size(d + 1);
+            strides[d] = control_points_.dimension().stride(d + 1);
+        }
+        function_type f{geometry_};
+        f.spline_.load_ctrlPts(MeshView<const val_type, dim>(
+            control_points_.data() +
+                func_ind * control_points_.dimension().stride(0),
+            MeshDimension<dim>(sizes, strides)));
+        return f;
+    }
+
+    // evaluation
+
+    /**
+     * @brief Get value of the func_ind-th function.
+     *
+     * @param func_ind function index
+     * @param coord coordinate array
+     */
+    val_type operator()(size_type func_ind, DimArray<coord_type> coord) const {
+        return value_at_(weights_(locate_(coord)), func_ind);
+    }
+
+    template <typename... Coords,
+              typename = typename std::enable_if<
+                  sizeof...(Coords) == dim &&
+                  std::is_arithmetic<
+                      typename std::common_type<Coords...>::type>::value>::type>
+    val_type operator()(size_type func_ind, Coords... x) const {
+        return operator()(func_ind,
+                          DimArray<coord_type>{static_cast<coord_type>(x)...});
+    }
+
+    /**
+     * @brief Get values of a subset of functions at one point, sharing the
+     * knot lookup and base spline computation.
+     *
+     * @param coord coordinate array
+     * @param func_first, func_last range of function indices
+     * @param d_first beginning of the destination range
+     */
+    template <typename InputIter, typename OutputIter>
+    OutputIter evaluate(DimArray<coord_type> coord,
+                        InputIter func_first,
+                        InputIter func_last,
+                        OutputIter d_first) const {
+        const auto& weights = weights_(locate_(coord));
+        for (; func_first != func_last; ++func_first, ++d_first) {
+            *d_first = value_at_(weights, static_cast<size_type>(*func_first));
+        }
+        return d_first;
+    }
+
+    /**
+     * @brief Get values of all functions at one point, sharing the knot
+     * lookup and base spline computation. In interleaved layout, the
+     * innermost loop runs over adjacent control points of all functions.
+     *
+     * @param coord coordinate array
+     * @param d_first beginning of the destination range
+     */
+    template <typename OutputIter>
+    OutputIter evaluate(DimArray<coord_type> coord, OutputIter d_first) const {
+        const auto& weights = weights_(locate_(coord));
+        if (layout_ == CollectionLayout::planar) {
+            for (size_type k = 0; k < size(); ++k, ++d_first) {
+                *d_first = value_at_(weights, k);
+            }
+            return d_first;
+        }
+        thread_local std::vector<val_type> values;
+        values.assign(size(), val_type{});
+        for (const auto& w : weights) {
+            const val_type* ctrl_pts = control_points_.data() + w.second;
+            for (size_type k = 0; k < values.size(); ++k) {
+                values[k] += w.first * ctrl_pts[k];
+            }
+        }
+        return std::copy(values.begin(), values.end(), d_first);
+    }
+};
+
+}  // namespace intp
+
+#endif
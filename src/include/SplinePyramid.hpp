@@ -0,0 +1,268 @@
+#ifndef INTP_SPLINE_PYRAMID
+#define INTP_SPLINE_PYRAMID
+
+#include <algorithm>  // max
+#include <array>
+#include <cmath>    // abs
+#include <cstddef>  // ptrdiff_t
+#include <limits>
+#include <stdexcept>  // domain_error
+#include <utility>    // move, pair
+#include <vector>
+
+#include "Interpolation.hpp"
+
+namespace intp {
+
+/**
+ * @brief Multi-resolution pyramid of a spline function on uniform grid, for
+ * cheap approximate evaluation. Level 0 is the function itself, and each
+ * following level interpolates it on a grid of half as many points along
+ * every dimension still long enough, i.e. it is the spline-prefiltered
+ * decimation of the function. Coarse levels are small enough to stay in
+ * cache.
+ *
+ * @tparam T Type of function value
+ * @tparam D Dimension
+ */
+template <typename T, size_t D>
+class SplinePyramid {
+   public:
+    using function_type = InterpolationFunction<T, D>;
+    using val_type = T;
+    using size_type = typename function_type::size_type;
+    using coord_type = typename function_type::coord_type;
+
+    const static size_type dim = D;
+
+    template <typename U>
+    using DimArray = std::array<U, dim>;
+
+   private:
+    std::vector<function_type> levels_;
+    // estimated maximum deviation of each level from level 0, sampled on
+    // nodes and segment midpoints of the next finer grid
+    std::vector<val_type> errors_;
+    // grid spacing of each level
+    std::vector<DimArray<coord_type>> spacings_;
+    // coordinates of the first and last grid points, which differ from the
+    // spline range in periodic dimension of even order by half a spacing
+    DimArray<std::pair<coord_type, coord_type>> ranges_;
+
+    // number of grid points evaluated at a time in error estimation
+    static constexpr size_type slab_points_ = size_type{1} << 16;
+
+    /**
+     * @brief Coordinates of n grid points spanning the range of dimension d.
+     *
+     */
+    std::vector<coord_type> nodes_(size_type d, size_type n) const {
+        const auto& range = ranges_[d];
+        std::vector<coord_type> nodes(n);
+        for (size_type i = 0; i < n; ++i) {
+            nodes[i] = range.first + (range.second - range.first) *
+                                         static_cast<coord_type>(i) /
+                                         static_cast<coord_type>(n - 1);
+        }
+        return nodes;
+    }
+
+    DimArray<std::vector<coord_type>> grid_(
+        const DimArray<size_type>& sizes) const {
+        DimArray<std::vector<coord_type>> grid;
+        for (size_type d = 0; d < dim; ++d) { grid[d] = nodes_(d, sizes[d]); }
+        return grid;
+    }
+
+    template <size_type... di>
+    function_type fit_(util::index_sequence<di...>,
+                       const Mesh<val_type, dim>& samples) const {
+        const auto& f = levels_.front();
+        DimArray<bool> periodicity;
+        for (size_type d = 0; d < dim; ++d) {
+            periodicity[d] = f.periodicity(d);
+        }
+        const InterpolationFunctionTemplate<val_type, dim> interp_template(
+            f.order, periodicity, samples.dimension(), ranges_[di]...);
+        return interp_template.interpolate(samples);
+    }
+
+    /**
+     * @brief Maximum deviation of a level from level 0 on a grid, evaluated
+     * separably in slabs along the first dimension to bound memory use.
+     *
+     */
+    val_type deviation_(const function_type& level,
+                        DimArray<std::vector<coord_type>> grid) const {
+        const auto& f0 = levels_.front();
+        size_type plane_points = 1;
+        for (size_type d = 1; d < dim; ++d) { plane_points *= grid[d].size(); }
+        const size_type slab =
+            std::max(size_type{1}, slab_points_ / plane_points);
+        const auto first_coords = std::move(grid[0]);
+        val_type deviation{};
+        for (size_type p0 = 0; p0 < first_coords.size(); p0 += slab) {
+            grid[0].assign(
+                first_coords.begin() + static_cast<std::ptrdiff_t>(p0),
+                first_coords.begin() + static_cast<std::ptrdiff_t>(std::min(
+                                           p0 + slab, first_coords.size())));
+            const auto exact = f0.spline().evaluate_grid(grid);
+            const auto approx = level.spline().evaluate_grid(grid);
+            for (size_type i = 0; i < exact.size(); ++i) {
+                deviation = std::max(
+                    deviation, std::abs(approx.data()[i] - exact.data()[i]));
+            }
+        }
+        return deviation;
+    }
+
+   public:
+    /**
+     * @brief Construct a new Spline Pyramid object
+     *
+     * @param f a function on uniform grid in every dimension, of the same
+     * order in every dimension
+     * @param max_level_num maximum number of levels, including f itself
+     */
+    explicit SplinePyramid(
+        function_type f,
+        size_type max_level_num = std::numeric_limits<size_type>::max()) {
+        const auto& spline = f.spline();
+        DimArray<size_type> sizes;
+        DimArray<coord_type> spacing;
+        for (size_type d = 0; d < dim; ++d) {
+            if (!f.uniform(d) || spline.dim_order(d) != f.order) {
+                throw std::domain_error(
+                    "Spline pyramid requires uniform grid and the same order "
+                    "in every dimension.");
+            }
+            // number of grid points, including the last point of periodic
+            // dimension, whose knot vector has one more knot for even order
+            sizes[d] = spline.knots_num(d) - f.order -
+                       (f.periodicity(d) ? f.order + (1 - f.order % 2)
+                                         : size_type{1});
+            spacing[d] = (f.range(d).second - f.range(d).first) /
+                         static_cast<coord_type>(sizes[d] - 1);
+            const coord_type shift = f.periodicity(d) && f.order % 2 == 0
+                                         ? spacing[d] / 2
+                                         : coord_type{};
+            ranges_[d] = std::make_pair(f.range(d).first + shift,
+                                        f.range(d).second + shift);
+        }
+        levels_.push_back(std::move(f));
+        errors_.push_back(val_type{});
+        spacings_.push_back(spacing);
+
+        // enough points for the coarse level to resolve anything
+        const size_type min_size = 2 * (levels_.front().order + 1);
+        while (levels_.size() < max_level_num) {
+            DimArray<size_type> coarse_sizes = sizes;
+            bool halved = false;
+            for (size_type d = 0; d < dim; ++d) {
+                const size_type half = sizes[d] / 2 + 1;
+                if (half >= min_size) {
+                    coarse_sizes[d] = half;
+                    halved = true;
+                }
+            }
+            if (!halved) { break; }
+
+            // levels_ is not referenced across push_back, which may reallocate
+            const auto coarse_samples =
+                levels_.front().spline().evaluate_grid(grid_(coarse_sizes));
+            levels_.push_back(
+                fit_(util::make_index_sequence<dim>{}, coarse_samples));
+
+            // Deviation from level 0 is sampled on nodes and segment midpoints
+            // of the finer grid, i.e. on a grid refined from it once.
+            DimArray<size_type> refined_sizes;
+            for (size_type d = 0; d < dim; ++d) {
+                refined_sizes[d] = 2 * sizes[d] - 1;
+            }
+            const val_type error =
+                std::max(errors_.back(),
+                         deviation_(levels_.back(), grid_(refined_sizes)));
+            errors_.push_back(error);
+
+            for (size_type d = 0; d < dim; ++d) {
+                const auto& range = ranges_[d];
+                spacing[d] = (range.second - range.first) /
+                             static_cast<coord_type>(coarse_sizes[d] - 1);
+            }
+            spacings_.push_back(spacing);
+            sizes = coarse_sizes;
+        }
+    }
+
+    // properties
+
+    /**
+     * @brief Number of levels, including the original function.
+     *
+     */
+    size_type size() const { return levels_.size(); }
+
+    const function_type& level(size_type level_ind) const {
+        return levels_[level_ind];
+    }
+
+    /**
+     * @brief Estimated maximum deviation of a level from the original
+     * function, sampled on nodes and segment midpoints of the grid of the next
+     * finer level. It is not a guaranteed bound, though deviation between
+     * samples is small for functions resolved by the finer grid.
+     *
+     */
+    val_type error(size_type level_ind) const { return errors_[level_ind]; }
+
+    /**
+     * @brief Grid spacing of a level in given dimension.
+     *
+     */
+    coord_type spacing(size_type level_ind, size_type dim_ind) const {
+        return spacings_[level_ind][dim_ind];
+    }
+
+    // level selection
+
+    /**
+     * @brief Index of the coarsest level whose estimated error is within
+     * tolerance. It is a heuristic, as the estimate is sampled (see `error`).
+     *
+     */
+    size_type level_for_tolerance(val_type tolerance) const {
+        size_type l = 0;
+        while (l + 1 < size() && errors_[l + 1] <= tolerance) { ++l; }
+        return l;
+    }
+
+    /**
+     * @brief Index of the coarsest level whose grid spacing is no larger than
+     * footprint (e.g. the extent of a pixel) in every dimension.
+     *
+     */
+    size_type level_for_footprint(DimArray<coord_type> footprint) const {
+        size_type l = 0;
+        for (; l + 1 < size(); ++l) {
+            bool fine_enough = true;
+            for (size_type d = 0; d < dim; ++d) {
+                fine_enough =
+                    fine_enough && spacings_[l + 1][d] <= footprint[d];
+            }
+            if (!fine_enough) { break; }
+        }
+        return l;
+    }
+
+    const function_type& for_tolerance(val_type tolerance) const {
+        return levels_[level_for_tolerance(tolerance)];
+    }
+
+    const function_type& for_footprint(DimArray<coord_type> footprint) const {
+        return levels_[level_for_footprint(footprint)];
+    }
+};
+
+}  // namespace intp
+
+#endif
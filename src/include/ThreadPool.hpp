@@ -0,0 +1,301 @@
+#ifndef INTP_THREAD_POOL
+#define INTP_THREAD_POOL
+
+#include <algorithm>  // min, max
+#include <condition_variable>
+#include <cstddef>
+#include <exception>  // exception_ptr
+#include <functional>
+#include <iterator>  // iterator_traits
+#include <memory>    // unique_ptr
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>  // move
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>  // pthread_setaffinity_np
+#endif
+
+namespace intp {
+
+/**
+ * @brief A fixed number of worker threads running submitted tasks in order of
+ * submission. It serves as the default executor of `parallel_for` and
+ * `parallel_evaluate`, which do their own work stealing.
+ *
+ */
+class ThreadPool {
+   public:
+    using size_type = std::size_t;
+    using task_type = std::function<void()>;
+
+   private:
+    std::vector<std::thread> workers_;
+    std::queue<task_type> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+
+    /**
+     * @brief Bind the calling thread to one CPU. It is a no-op on platforms
+     * other than Linux.
+     *
+     */
+    static void pin_to_cpu_(size_type cpu) {
+#if defined(__linux__)
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(cpu, &cpu_set);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
+#else
+        static_cast<void>(cpu);
+#endif
+    }
+
+    void work_(size_type worker_ind, bool pin_threads) {
+        if (pin_threads) {
+            pin_to_cpu_(worker_ind %
+                        std::max(1u, std::thread::hardware_concurrency()));
+        }
+        for (;;) {
+            task_type task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+                if (tasks_.empty()) { return; }
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+    }
+
+   public:
+    /**
+     * @brief Construct a new Thread Pool object
+     *
+     * @param thread_num number of worker threads, defaulted to number of
+     * hardware threads
+     * @param pin_threads whether to bind the i-th worker to the i-th CPU
+     * (Linux only)
+     */
+    explicit ThreadPool(
+        size_type thread_num = std::max(1u,
+                                        std::thread::hardware_concurrency()),
+        bool pin_threads = false) {
+        workers_.reserve(thread_num);
+        for (size_type i = 0; i < thread_num; ++i) {
+            workers_.emplace_back(&ThreadPool::work_, this, i, pin_threads);
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Finish remaining tasks and join worker threads.
+     *
+     */
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& w : workers_) { w.join(); }
+    }
+
+    size_type size() const { return workers_.size(); }
+
+    void submit(task_type task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push(std::move(task));
+        }
+        cv_.notify_one();
+    }
+};
+
+/**
+ * @brief Call func(begin, end) on chunks covering [0, n), by worker_num
+ * workers, i.e. the calling thread and worker_num - 1 tasks run on an
+ * executor. Each worker owns a contiguous share of the range, and
+ * takes chunks from its front, a fraction of what remains but no less than
+ * min_chunk, so that chunks shrink towards the end. A worker running out of
+ * work steals the back half of the largest share left. Thus uneven cost of
+ * chunks is balanced without a central queue. The call returns after all
+ * workers finish, so it must not be made from a task of a saturated executor.
+ *
+ * @param n length of the range
+ * @param func callable on chunk bounds, invoked concurrently
+ * @param executor callable taking a `std::function<void()>`, running it
+ * eventually (possibly in the calling thread)
+ * @param worker_num number of workers, including the calling thread
+ * @param min_chunk minimum chunk length
+ */
+template <typename Func, typename Executor>
+void parallel_for(std::size_t n,
+                  Func&& func,
+                  Executor&& executor,
+                  std::size_t worker_num,
+                  std::size_t min_chunk = 256) {
+    using size_type = std::size_t;
+    worker_num = std::max(size_type{1},
+                          std::min(worker_num, n / std::max(size_type{1},
+                                                            min_chunk)));
+    min_chunk = std::max(size_type{1}, min_chunk);
+
+    struct Share {
+        std::mutex mutex;
+        size_type begin;
+        size_type end;
+    };
+    std::unique_ptr<Share[]> shares(new Share[worker_num]);
+    for (size_type w = 0; w < worker_num; ++w) {
+        shares[w].begin = n * w / worker_num;
+        shares[w].end = n * (w + 1) / worker_num;
+    }
+
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+    size_type done_num = 0;
+    std::exception_ptr error;
+
+    const auto work = [&](size_type w) {
+        Share& own = shares[w];
+        try {
+            for (;;) {
+                size_type begin, end;
+                {
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    const size_type rest = own.end - own.begin;
+                    begin = own.begin;
+                    end = begin + std::min(rest, std::max(min_chunk, rest / 8));
+                    own.begin = end;
+                }
+                if (begin != end) {
+                    func(begin, end);
+                    continue;
+                }
+                // steal the back half of the largest share
+                size_type victim = worker_num, victim_rest = 0;
+                for (size_type v = 0; v < worker_num; ++v) {
+                    std::lock_guard<std::mutex> lock(shares[v].mutex);
+                    const size_type rest = shares[v].end - shares[v].begin;
+                    if (rest > victim_rest) {
+                        victim = v;
+                        victim_rest = rest;
+                    }
+                }
+                if (victim == worker_num) { break; }
+                {
+                    std::lock_guard<std::mutex> lock(shares[victim].mutex);
+                    Share& s = shares[victim];
+                    const size_type rest = s.end - s.begin;
+                    // take all of a small share, otherwise the back half
+                    begin = rest < 2 * min_chunk ? s.begin : s.end - rest / 2;
+                    end = s.end;
+                    s.end = begin;
+                }
+                std::lock_guard<std::mutex> lock(own.mutex);
+                own.begin = begin;
+                own.end = end;
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(done_mutex);
+            if (!error) { error = std::current_exception(); }
+        }
+        // notified under the lock, since the waiting thread destroys done_cv
+        // right after waking up
+        std::lock_guard<std::mutex> lock(done_mutex);
+        ++done_num;
+        done_cv.notify_one();
+    };
+
+    for (size_type w = 1; w < worker_num; ++w) {
+        executor(std::function<void()>([&work, w] { work(w); }));
+    }
+    work(0);
+    std::unique_lock<std::mutex> lock(done_mutex);
+    done_cv.wait(lock, [&] { return done_num == worker_num; });
+    if (error) { std::rethrow_exception(error); }
+}
+
+/**
+ * @brief Call func(begin, end) on chunks covering [0, n) on a thread pool and
+ * the calling thread. See the overload with executor.
+ *
+ */
+template <typename Func>
+void parallel_for(std::size_t n,
+                  Func&& func,
+                  ThreadPool& pool,
+                  std::size_t min_chunk = 256) {
+    parallel_for(
+        n, std::forward<Func>(func),
+        [&pool](std::function<void()> task) { pool.submit(std::move(task)); },
+        pool.size() + 1, min_chunk);
+}
+
+/**
+ * @brief Evaluate a function (e.g. an `InterpolationFunction`) at a batch of
+ * points in parallel, using the pipelined batch evaluation of the function on
+ * each chunk. The function object is shared by all threads.
+ *
+ * @param func function providing `evaluate(first, last, d_first)`
+ * @param first, last range of coordinate arrays
+ * @param d_first beginning of the destination range
+ * @param executor callable taking a `std::function<void()>`
+ * @param worker_num number of workers, including the calling thread
+ * @param min_chunk minimum number of points evaluated in a chunk
+ * @return end of the destination range
+ */
+template <typename Function,
+          typename RandomIt,
+          typename RandomOutputIt,
+          typename Executor>
+RandomOutputIt parallel_evaluate(const Function& func,
+                                 RandomIt first,
+                                 RandomIt last,
+                                 RandomOutputIt d_first,
+                                 Executor&& executor,
+                                 std::size_t worker_num,
+                                 std::size_t min_chunk = 256) {
+    using diff_type = typename std::iterator_traits<RandomIt>::difference_type;
+    using out_diff_type =
+        typename std::iterator_traits<RandomOutputIt>::difference_type;
+    const auto n = static_cast<std::size_t>(last - first);
+    parallel_for(
+        n,
+        [&](std::size_t begin, std::size_t end) {
+            func.evaluate(first + static_cast<diff_type>(begin),
+                          first + static_cast<diff_type>(end),
+                          d_first + static_cast<out_diff_type>(begin));
+        },
+        std::forward<Executor>(executor), worker_num, min_chunk);
+    return d_first + static_cast<out_diff_type>(n);
+}
+
+/**
+ * @brief Evaluate a function at a batch of points on a thread pool and the
+ * calling thread. See the overload with executor.
+ *
+ */
+template <typename Function, typename RandomIt, typename RandomOutputIt>
+RandomOutputIt parallel_evaluate(const Function& func,
+                                 RandomIt first,
+                                 RandomIt last,
+                                 RandomOutputIt d_first,
+                                 ThreadPool& pool,
+                                 std::size_t min_chunk = 256) {
+    return parallel_evaluate(
+        func, first, last, d_first,
+        [&pool](std::function<void()> task) { pool.submit(std::move(task)); },
+        pool.size() + 1, min_chunk);
+}
+
+}  // namespace intp
+
+#endif
@@ -3,16 +3,19 @@
 #include "include/Assertion.hpp"
 #include "include/rel_err.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <iostream>
 #include <random>
 
-template <typename Mat, typename Vec>
+template <template <typename> class Solver = intp::BandLU,
+          typename Mat,
+          typename Vec>
 void check_solver(Mat&& mat, const Vec& b, Assertion& assertion) {
     using namespace intp;
 
-    BandLU<util::remove_cvref_t<Mat>> solver{mat};
+    Solver<util::remove_cvref_t<Mat>> solver{mat};
     auto x = solver.solve(b);
     auto bb = mat * x;
 
@@ -22,6 +25,44 @@ void check_solver(Mat&& mat, const Vec& b, Assertion& assertion) {
 
     assertion(d < 1e-10);
     std::cout << "\n||b - A . x||/||b|| = " << d << '\n';
+
+    // block solving of b, 2b and reversed b, with padded rows
+    constexpr std::size_t width = 3;
+    constexpr std::size_t pitch = 4;
+    const std::size_t n = b.size();
+    std::vector<double> block(n * pitch);
+    for (std::size_t i = 0; i < n; ++i) {
+        block[i * pitch] = b[i];
+        block[i * pitch + 1] = 2 * b[i];
+        block[i * pitch + 2] = b[n - 1 - i];
+    }
+    solver.solve_block_in_place(block.data(), pitch, width);
+    auto x_rev = solver.solve(std::vector<double>(b.rbegin(), b.rend()));
+    double block_diff{}, x_max{};
+    for (std::size_t i = 0; i < n; ++i) {
+        x_max = std::max(x_max, std::abs(x[i]));
+        block_diff = std::max(
+            {block_diff, std::abs(block[i * pitch] - x[i]),
+             std::abs(block[i * pitch + 1] - 2 * x[i]),
+             std::abs(block[i * pitch + 2] - x_rev[i])});
+    }
+    assertion(block_diff < 1e-12 * x_max);
+    std::cout << "Block solving deviation = " << block_diff / x_max << '\n';
+
+    // infinity norm of inverse, as largest row sum of solutions of unit
+    // vectors
+    std::vector<double> row_sum(n);
+    for (std::size_t j = 0; j < n; ++j) {
+        std::vector<double> e(n);
+        e[j] = 1;
+        solver.solve_in_place(e);
+        for (std::size_t i = 0; i < n; ++i) { row_sum[i] += std::abs(e[i]); }
+    }
+    const double inv_norm = *std::max_element(row_sum.begin(), row_sum.end());
+    const double inv_norm_bound = solver.inverse_norm_bound();
+    assertion(inv_norm <= inv_norm_bound * (1 + 1e-12));
+    std::cout << "||A^{-1}|| = " << inv_norm << ", bounded by "
+              << inv_norm_bound << '\n';
 }
 
 int main() {
@@ -58,6 +99,26 @@ int main() {
         check_solver(std::move(mat), b, assertion);
     }
 
+    // band matrix solved by recursive filter
+    {
+        // Basic spline value of order 4, with boundary rows of not-a-knot
+        // like condition
+        BandMatrix<double> mat{n, 2, 2};
+        for (size_t i = 2; i < n - 2; ++i) {
+            mat(i, i) = 115. / 192.;
+            mat(i, i - 1) = 19. / 96.;
+            mat(i, i + 1) = 19. / 96.;
+            mat(i, i - 2) = 1. / 384.;
+            mat(i, i + 2) = 1. / 384.;
+        }
+        for (size_t i : {size_t{0}, size_t{1}, n - 2, n - 1}) {
+            mat(i, i) = 1.;
+            mat(i, i < 2 ? i + 1 : i - 1) = .5;
+        }
+        std::cout << "\nBand matrix, recursive filter, 4th order BSpline\n";
+        check_solver<RecursiveFilter>(std::move(mat), b, assertion);
+    }
+
     // band matrix with extra side bands
     {
         // band matrix with lower and upper bandwidth = 1
@@ -98,5 +159,49 @@ int main() {
         check_solver(std::move(mat3), b, assertion);
     }
 
+    // circulant band matrix
+    {
+        // Basic spline value of order 3
+        CirculantBandMatrix<double> mat1{n, 1, 1};
+        mat1(0, n - 1) = 1. / 6.;
+        mat1(0, 0) = 2. / 3.;
+        mat1(0, 1) = 1. / 6.;
+        std::cout << "\nBand matrix, circulant, 3rd order BSpline\n";
+        check_solver(mat1, b, assertion);
+
+        // Basic spline value of order 4, set row by row
+        CirculantBandMatrix<double> mat2{n, 2, 2};
+        for (size_t i = 0; i < n; ++i) {
+            mat2(i, i) = 115. / 192.;
+            mat2(i, (i + n - 1) % n) = 19. / 96.;
+            mat2(i, (i + 1) % n) = 19. / 96.;
+            mat2(i, (i + n - 2) % n) = 1. / 384.;
+            mat2(i, (i + 2) % n) = 1. / 384.;
+        }
+        std::cout << "\nBand matrix, circulant, 4th order BSpline\n";
+        check_solver(mat2, b, assertion);
+
+        // Basic spline value of order 5, on a matrix of small dimension
+        CirculantBandMatrix<double> mat3{5, 2, 2};
+        mat3(2, 0) = 1. / 120.;
+        mat3(2, 1) = 26. / 120.;
+        mat3(2, 2) = 66. / 120.;
+        mat3(2, 3) = 26. / 120.;
+        mat3(2, 4) = 1. / 120.;
+        std::cout << "\nBand matrix, circulant, 5th order BSpline, n = 5\n";
+        check_solver(mat3, std::vector<double>(b.begin(), b.begin() + 5),
+                     assertion);
+
+        CirculantBandMatrix<double> mat4{n, 1, 1};
+        mat4(0, n - 1) = 1. / 3.;
+        mat4(0, 0) = 1.;
+        try {
+            BandLU<CirculantBandMatrix<double>> solver{mat4};
+            assertion(false, "Asymmetric circulant matrix check failed.");
+        } catch (const std::domain_error&) {
+            std::cout << "\nAsymmetric circulant matrix check succeed.\n";
+        }
+    }
+
     return assertion.status();
 }
@@ -122,6 +122,84 @@ int main() {
               << (assertion.last_status() == 0 ? "succeed" : "failed") << '\n';
     std::cout << "Relative Error = " << d << '\n';
 
+    {
+        // control points in column-major external storage, either copied or
+        // referred to by the spline
+        std::array<double, 25> cp2d_col;
+        for (unsigned i = 0; i < 5; ++i) {
+            for (unsigned j = 0; j < 5; ++j) {
+                cp2d_col[i + 5 * j] = cp2[i][j];
+            }
+        }
+        const MeshView<const double, 2> cp2d_view(cp2d_col.data(), {5, 5},
+                                                  Layout::col_major);
+        auto spline_2d_3_copy = spline_2d_3;
+        spline_2d_3_copy.load_ctrlPts(cp2d_view);
+        BSpline<double, 2, MeshView<const double, 2>> spline_2d_3_view(
+            3, cp2d_view, make_pair(knots.begin(), knots.end()),
+            make_pair(knots.begin(), knots.end()));
+        double diff{};
+        for (const auto& c : coords_2d) {
+            const double v = spline_2d_3(c.first, c.second);
+            diff = std::max(
+                {diff, std::abs(spline_2d_3_copy(c.first, c.second) - v),
+                 std::abs(spline_2d_3_view(c.first, c.second) - v)});
+        }
+        assertion(diff == 0);
+        std::cout << "\n2D test of control points in mesh view "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+    }
+
+    {
+        // derived splines of column-major and strided control points
+        Mesh<double, 2> cp2d_col(MeshDimension<2>({5, 5}, Layout::col_major));
+        Mesh<double, 2> cp2d_strided(MeshDimension<2>({5, 5}, {1, 7}));
+        for (unsigned i = 0; i < 5; ++i) {
+            for (unsigned j = 0; j < 5; ++j) {
+                cp2d_col(i, j) = cp2[i][j];
+                cp2d_strided(i, j) = cp2[i][j];
+            }
+        }
+        const BSpline<double, 2> spline_2d_3_col(
+            3, cp2d_col, make_pair(knots.begin(), knots.end()),
+            make_pair(knots.begin(), knots.end()));
+        const BSpline<double, 2> spline_2d_3_strided(
+            3, cp2d_strided, make_pair(knots.begin(), knots.end()),
+            make_pair(knots.begin(), knots.end()));
+
+        const std::array<std::pair<double, double>, 2> box{
+            {{.1, .9}, {.2, .7}}};
+        const double integral = spline_2d_3.integrate(box);
+        double diff = std::max(
+            std::abs(spline_2d_3_col.integrate(box) - integral),
+            std::abs(spline_2d_3_strided.integrate(box) - integral));
+        for (unsigned d = 0; d < 2; ++d) {
+            std::array<std::size_t, 2> orders{};
+            orders[d] = 1;
+            const auto deri = spline_2d_3.differentiate(orders);
+            const auto deri_col = spline_2d_3_col.differentiate(orders);
+            const auto deri_strided = spline_2d_3_strided.differentiate(orders);
+            const auto bound = spline_2d_3.bind(d, .3, 0);
+            const auto bound_col = spline_2d_3_col.bind(d, .3, 0);
+            const auto bound_strided = spline_2d_3_strided.bind(d, .3, 0);
+            for (const auto& c : coords_2d) {
+                const double v = deri(c.first, c.second);
+                const double b = bound(c.first);
+                diff = std::max(
+                    {diff, std::abs(deri_col(c.first, c.second) - v),
+                     std::abs(deri_strided(c.first, c.second) - v),
+                     std::abs(bound_col(c.first) - b),
+                     std::abs(bound_strided(c.first) - b)});
+            }
+        }
+        assertion(diff < tol);
+        std::cout << "\n2D test of derived splines of column-major control "
+                     "points "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+    }
+
     // 3D Spline
 
     // random 5x5x5 control points
@@ -235,6 +313,28 @@ int main() {
               << (assertion.last_status() == 0 ? "succeed" : "failed") << '\n';
     std::cout << "Relative Error = " << d << '\n';
 
+    {
+        // values on grid, evaluated separably, with the periodic dimension
+        // covering more than one period
+        std::array<std::vector<double>, 2> grid;
+        for (int i = 0; i <= 20; ++i) { grid[0].push_back(.05 * i); }
+        for (int j = 0; j <= 30; ++j) { grid[1].push_back(-.5 + .1 * j); }
+        const auto values = spline_2d_3_periodic.evaluate_grid(grid);
+        double diff{};
+        for (std::size_t i = 0; i < grid[0].size(); ++i) {
+            for (std::size_t j = 0; j < grid[1].size(); ++j) {
+                diff = std::max(
+                    diff, std::abs(values(i, j) - spline_2d_3_periodic(
+                                                      grid[0][i], grid[1][j])));
+            }
+        }
+        assertion(values.dim_size(0) == 21 && values.dim_size(1) == 31 &&
+                  diff < tol);
+        std::cout << "\n2D test of evaluation on grid "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+    }
+
     // 1D derivative
 
     std::cout << "\n1D B-Spline derivative Test:\n";
@@ -0,0 +1,184 @@
+#include <ChunkedMesh.hpp>
+#include <Interpolation.hpp>
+#include "include/Assertion.hpp"
+
+#include <cmath>
+#include <cstdio>  // remove
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+int main() {
+    using namespace intp;
+
+    Assertion assertion;
+
+    const std::string brick_file = "chunked-mesh-test.brk";
+    const std::string raw_file = "chunked-mesh-test.bin";
+
+    Mesh<double, 3> mesh({23, 17, 30});
+    for (std::size_t i = 0; i < mesh.size(); ++i) {
+        *(mesh.data() + i) = std::sin(.01 * static_cast<double>(i));
+    }
+    ChunkedMesh<double, 3>::write(mesh, 8, brick_file);
+
+    // values and lazy loading
+
+    {
+        const ChunkedMesh<double, 3> chunked(brick_file, 4);
+        assertion(chunked.dim_size(0) == 23 && chunked.dim_size(1) == 17 &&
+                  chunked.dim_size(2) == 30 && chunked.brick_extent() == 8);
+        assertion(chunked.brick_loads() == 0);
+        // all in the first brick
+        assertion(chunked(0, 0, 0) == mesh(0, 0, 0) &&
+                  chunked(7, 7, 7) == mesh(7, 7, 7) &&
+                  chunked(3, 5, 1) == mesh(3, 5, 1));
+        assertion(chunked.brick_loads() == 1);
+
+        bool equal = true;
+        for (auto it = mesh.begin(); it != mesh.end(); ++it) {
+            equal = equal && chunked(mesh.iter_indices(it)) == *it;
+        }
+        assertion(equal);
+        std::cout << "\nChunked mesh values test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ".\n";
+    }
+
+    // least recently used brick is evicted
+
+    {
+        const ChunkedMesh<double, 3> chunked(brick_file, 3);
+        double sum{};
+        sum += chunked(0, 0, 0);   // brick A
+        sum += chunked(8, 0, 0);   // brick B
+        sum += chunked(16, 0, 0);  // brick C
+        sum += chunked(0, 0, 1);   // A again
+        sum += chunked(0, 8, 0);   // brick D, evicts B
+        assertion(chunked.brick_loads() == 4);
+        sum += chunked(1, 1, 1);  // A
+        sum += chunked(16, 1, 0);  // C
+        assertion(chunked.brick_loads() == 4);
+        sum += chunked(8, 1, 1);  // B, loaded again
+        assertion(chunked.brick_loads() == 5);
+        std::cout << "\nChunked mesh LRU cache test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ".\n";
+    }
+
+    // bricks prefetched by reader threads
+
+    {
+        const ChunkedMesh<double, 3> chunked(brick_file, 8);
+        chunked.prefetch({0, 0, 0});
+        chunked.prefetch({8, 0, 0});
+        chunked.prefetch({0, 0, 0});
+        assertion(chunked(1, 2, 3) == mesh(1, 2, 3) &&
+                  chunked(9, 2, 3) == mesh(9, 2, 3));
+        // each brick is read once, either by a reader or on access
+        assertion(chunked.brick_loads() == 2);
+        // some left pending when the storage is destroyed
+        for (std::size_t i = 0; i < 16; i += 8) {
+            for (std::size_t j = 0; j < 24; j += 8) {
+                chunked.prefetch({i, 8, j});
+            }
+        }
+        std::cout << "\nChunked mesh prefetch test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ".\n";
+    }
+
+    // concurrent readers sharing one cache
+
+    {
+        const ChunkedMesh<double, 3> chunked(brick_file, 5);
+        std::vector<int> mismatches(4);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < mismatches.size(); ++t) {
+            threads.emplace_back([&, t]() {
+                std::mt19937 gen(static_cast<unsigned>(t));
+                for (int i = 0; i < 20000; ++i) {
+                    const std::array<std::size_t, 3> ind{
+                        gen() % mesh.dim_size(0), gen() % mesh.dim_size(1),
+                        gen() % mesh.dim_size(2)};
+                    if (chunked(ind) != mesh(ind)) { ++mismatches[t]; }
+                }
+            });
+        }
+        for (auto& t : threads) { t.join(); }
+        for (auto m : mismatches) { assertion(m == 0); }
+        std::cout << "\nChunked mesh concurrent read test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ".\n";
+    }
+
+    // B-spline evaluated from control points in bricks, converted from
+    // out-of-core fitting output
+
+    {
+        const InterpolationFunctionTemplate<double, 3> t(
+            3, mesh.dimension(), std::make_pair(0., 1.), std::make_pair(0., 1.),
+            std::make_pair(0., 1.));
+        const auto interp = t.interpolate(mesh);
+        {
+            std::ofstream out(raw_file, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(mesh.data()),
+                      static_cast<std::streamsize>(mesh.size() *
+                                                   sizeof(double)));
+        }
+        t.interpolate_out_of_core(raw_file, raw_file + ".ctrl", 1 << 20);
+        ChunkedMesh<double, 3>::write(raw_file + ".ctrl",
+                                      t.control_point_dimension(), 8,
+                                      brick_file);
+
+        const auto& s = interp.spline();
+        const BSpline<double, 3, ChunkedMesh<double, 3>> chunked_spline(
+            3, ChunkedMesh<double, 3>(brick_file, 8),
+            std::make_pair(s.knots_begin(0), s.knots_end(0)),
+            std::make_pair(s.knots_begin(1), s.knots_end(1)),
+            std::make_pair(s.knots_begin(2), s.knots_end(2)));
+
+        std::mt19937 gen(1);
+        std::uniform_real_distribution<> dist(0, 1);
+        double max_diff{};
+        for (int i = 0; i < 1000; ++i) {
+            const double x = dist(gen), y = dist(gen), z = dist(gen);
+            max_diff = std::max(
+                max_diff, std::abs(interp(x, y, z) - chunked_spline(x, y, z)));
+        }
+        assertion(max_diff < 1e-14);
+        std::cout << "\nChunked control points test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ", max difference = " << max_diff << '\n';
+
+        // pipelined batch evaluation, with bricks read in background
+        std::vector<std::array<double, 3>> pts(2000);
+        for (auto& p : pts) {
+            for (auto& x : p) { x = dist(gen); }
+        }
+        const BSpline<double, 3, ChunkedMesh<double, 3>> cold_spline(
+            3, ChunkedMesh<double, 3>(brick_file, 8),
+            std::make_pair(s.knots_begin(0), s.knots_end(0)),
+            std::make_pair(s.knots_begin(1), s.knots_end(1)),
+            std::make_pair(s.knots_begin(2), s.knots_end(2)));
+        std::vector<double> vals(pts.size());
+        cold_spline.evaluate(pts.begin(), pts.end(), vals.begin(), 16);
+        bool equal = true;
+        for (std::size_t i = 0; i < pts.size(); ++i) {
+            equal = equal && vals[i] == chunked_spline(pts[i][0], pts[i][1],
+                                                       pts[i][2]);
+        }
+        assertion(equal);
+        std::cout << "\nChunked batch evaluation test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ".\n";
+        std::remove((raw_file + ".ctrl").c_str());
+    }
+
+    std::remove(brick_file.c_str());
+    std::remove(raw_file.c_str());
+
+    return assertion.status();
+}
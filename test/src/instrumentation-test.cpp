@@ -0,0 +1,152 @@
+#ifndef INTP_ENABLE_INSTRUMENTATION
+#define INTP_ENABLE_INSTRUMENTATION
+#endif
+
+#include <Interpolation.hpp>
+#include "include/Assertion.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+int main() {
+    using namespace intp;
+
+    Assertion assertion;
+
+    std::vector<double> vals;
+    std::vector<double> coords;
+    for (int i = 0; i < 20; ++i) {
+        vals.push_back(std::sin(.3 * i));
+        coords.push_back(i + .01 * i * i);
+    }
+
+    // fitting phases
+
+    instrument::reset();
+    const InterpolationFunction1D<> uniform_interp(std::make_pair(0., 19.),
+                                                   util::get_range(vals));
+    const auto c = instrument::counters();
+    assertion(c.solver_builds == 1 && c.solves == 1 &&
+              c.solver_build_ns + c.solve_ns > 0);
+    std::cout << "\nFitting phase counters test "
+              << (assertion.last_status() == 0 ? "succeed" : "failed")
+              << ".\nbuild: " << c.solver_build_ns
+              << " ns, solve: " << c.solve_ns << " ns\n";
+
+    // evaluation and knot lookup
+
+    {
+        instrument::reset();
+        double sum{};
+        for (int i = 0; i < 100; ++i) { sum += uniform_interp(.19 * i); }
+        sum += uniform_interp(-1.) + uniform_interp(20.);
+        sum += uniform_interp.derivative(std::make_pair(1., 1));
+        const auto& c = instrument::counters();
+        // the hint of uniform dimension is always accurate
+        assertion(c.evaluations == 102 && c.derivative_evaluations == 1 &&
+                  c.out_of_range == 2 && c.knot_hint_miss <= 2 &&
+                  c.knot_hint_hit + c.knot_hint_miss == 103);
+        std::cout << "\nUniform evaluation counters test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ".\n";
+    }
+
+    {
+        const InterpolationFunction1D<> nonuniform_interp(
+            util::get_range(coords), util::get_range(vals));
+        instrument::reset();
+        double sum{};
+        for (int i = 0; i < 100; ++i) {
+            sum += nonuniform_interp(.2 * coords.back() + .006 * i);
+        }
+        const auto& c = instrument::counters();
+        // there is no hint for nonuniform dimension, thus binary search is
+        // needed
+        assertion(c.evaluations == 100 && c.knot_hint_miss == 100 &&
+                  c.binary_search_steps >= c.knot_hint_miss &&
+                  c.out_of_range == 0);
+        std::cout << "\nNonuniform evaluation counters test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ".\n";
+    }
+
+    // factorization cache
+
+    {
+        instrument::reset();
+        const InterpolationFunctionTemplate<double, 3> cube(
+            3, {false, false, false}, MeshDimension<3>(12),
+            std::make_pair(0., 1.), std::make_pair(0., 1.),
+            std::make_pair(0., 1.));
+        // all three dimensions share one factorization
+        assertion(instrument::counters().solver_cache_hits == 2);
+        // the same geometry in another scale, built concurrently
+        std::vector<std::uint64_t> thread_hits(4);
+        std::vector<std::thread> threads;
+        for (auto& hits : thread_hits) {
+            threads.emplace_back([&hits]() {
+                const InterpolationFunctionTemplate<double, 3> t(
+                    3, {false, false, false}, MeshDimension<3>(12),
+                    std::make_pair(-1., 1.), std::make_pair(0., 2.),
+                    std::make_pair(0., 3.));
+                hits = instrument::counters().solver_cache_hits;
+            });
+        }
+        for (auto& t : threads) { t.join(); }
+        for (auto hits : thread_hits) { assertion(hits == 3); }
+        const InterpolationFunctionTemplate<double, 3> other(
+            3, {false, true, false}, MeshDimension<3>{12, 13, 12},
+            std::make_pair(0., 1.), std::make_pair(0., 1.),
+            std::make_pair(0., 1.));
+        // the periodic dimension differs
+        assertion(instrument::counters().solver_cache_hits == 4);
+
+        Mesh<double, 3> f(12);
+        for (std::size_t i = 0; i < f.size(); ++i) {
+            *(f.data() + i) = std::sin(.1 * static_cast<double>(i));
+        }
+        const auto interp = cube.interpolate(f);
+        assertion(std::abs(interp(1. / 11, 2. / 11, 3. / 11) - f(1, 2, 3)) <
+                  1e-12);
+
+        // functions constructed one after another share factorizations,
+        // though no template outlives them
+        Mesh<double, 2> g({30, 40});
+        for (std::size_t i = 0; i < g.size(); ++i) {
+            *(g.data() + i) = std::cos(.1 * static_cast<double>(i));
+        }
+        {
+            const InterpolationFunction<double, 2> first(
+                3, g, std::make_pair(0., 1.), std::make_pair(0., 1.));
+        }
+        instrument::reset();
+        const InterpolationFunction<double, 2> second(
+            3, g, std::make_pair(0., 2.), std::make_pair(0., 3.));
+        assertion(instrument::counters().solver_cache_hits == 2);
+        InterpolationFunctionTemplate<double, 2>::release_solver_cache();
+        instrument::reset();
+        const InterpolationFunction<double, 2> third(
+            3, g, std::make_pair(0., 1.), std::make_pair(0., 1.));
+        assertion(instrument::counters().solver_cache_hits == 0);
+        std::cout << "\nFactorization cache test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ".\n";
+    }
+
+    // counters are thread local
+
+    {
+        instrument::reset();
+        std::thread t([&]() {
+            double sum{};
+            for (int i = 0; i < 10; ++i) { sum += uniform_interp(i); }
+        });
+        t.join();
+        assertion(instrument::counters().evaluations == 0,
+                  "Counters are not thread local.");
+    }
+
+    return assertion.status();
+}
@@ -3,6 +3,8 @@
 #include "include/rel_err.hpp"
 
 #include <chrono>
+#include <cstdio>  // remove
+#include <fstream>
 #include <iostream>
 #include <random>
 #include <vector>
@@ -268,5 +270,280 @@ int main() {
                   << err2_3d << '\n';
     }
 
+    // recursive filter fitting engine, compared with band LU
+
+    {
+        std::mt19937 rand_gen(42);
+        std::uniform_real_distribution<> rand_dist(-1, 1);
+        Mesh<double, 2> f({200, 60});
+        for (size_t i = 0; i < f.size(); ++i) {
+            *(f.data() + i) = rand_dist(rand_gen);
+        }
+        double max_diff{};
+        for (size_t order = 1; order < 8; ++order) {
+            InterpolationFunctionTemplate<double, 2> t(
+                order, {false, false}, f.dimension(), std::make_pair(0., 1.),
+                std::make_pair(0., 1.));
+            const auto interp_lu = t.interpolate(f);
+            t.fitting_engine(FittingEngine::recursive_filter);
+            const auto interp_rf = t.interpolate(f);
+            for (auto& c : coord_2d) {
+                const double x = c[0] / (2 * M_PI) + .5;
+                const double y = c[1] / (2 * M_PI) + .5;
+                max_diff = std::max(
+                    max_diff, std::abs(interp_lu(x, y) - interp_rf(x, y)));
+            }
+            // passes through data points, including the boundary ones
+            for (size_t i : {size_t{0}, size_t{1}, size_t{100}, size_t{199}}) {
+                max_diff = std::max(
+                    max_diff, std::abs(interp_rf(i / 199., 59. / 59.) -
+                                       f(i, 59)));
+            }
+        }
+        assertion(max_diff < 1e-12);
+        std::cout << "\nRecursive filter fitting engine test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ", max difference = " << max_diff << '\n';
+    }
+
+    // tiled dimension sweep, compared with strided one
+
+    {
+        std::mt19937 rand_gen(7);
+        std::uniform_real_distribution<> rand_dist(-1, 1);
+        // more lines than a tile holds along the first dimension
+        Mesh<double, 3> f({40, 31, 50});
+        for (size_t i = 0; i < f.size(); ++i) {
+            *(f.data() + i) = rand_dist(rand_gen);
+        }
+        InterpolationFunctionTemplate<double, 3> t(
+            3, {false, true, false}, f.dimension(), std::make_pair(0., 1.),
+            std::make_pair(0., 1.), std::make_pair(0., 1.));
+        assertion(t.sweep_strategy() == SweepStrategy::tiled);
+        const auto interp_tiled = t.interpolate(f);
+        t.sweep_strategy(SweepStrategy::strided);
+        const auto interp_strided = t.interpolate(f);
+        double max_diff{};
+        for (int i = 0; i < 1000; ++i) {
+            const double x = .5 * (rand_dist(rand_gen) + 1);
+            const double y = .5 * (rand_dist(rand_gen) + 1);
+            const double z = .5 * (rand_dist(rand_gen) + 1);
+            max_diff = std::max(max_diff, std::abs(interp_tiled(x, y, z) -
+                                                   interp_strided(x, y, z)));
+        }
+        // each line is solved by the same arithmetic
+        assertion(max_diff == 0.);
+        std::cout << "\nTiled sweep test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ", max difference = " << max_diff << '\n';
+    }
+
+    // incremental update of a sub-box, compared with full refit
+
+    {
+        std::mt19937 rand_gen(3);
+        std::uniform_real_distribution<> rand_dist(-1, 1);
+        Mesh<double, 3> f({60, 41, 30});
+        for (size_t i = 0; i < f.size(); ++i) {
+            *(f.data() + i) = rand_dist(rand_gen);
+        }
+        std::vector<double> z_coords;
+        for (size_t k = 0; k < f.dim_size(2); ++k) {
+            z_coords.push_back(k + .02 * k * k);
+        }
+        const InterpolationFunctionTemplate<double, 3> t(
+            3, {false, true, false}, f.dimension(), std::make_pair(0., 1.),
+            std::make_pair(0., 1.), util::get_range(z_coords));
+        auto interp_exact = t.interpolate(f);
+        auto interp_approx = interp_exact;
+
+        // the box reaches the end of periodic dimension, where the last
+        // point is ignored as in fitting
+        const std::array<size_t, 3> box_begin{20, 36, 0};
+        Mesh<double, 3> box({8, 5, 6});
+        for (size_t i = 0; i < box.size(); ++i) {
+            *(box.data() + i) = rand_dist(rand_gen);
+        }
+        for (auto it = box.begin(); it != box.end(); ++it) {
+            auto ind = box.iter_indices(it);
+            for (size_t d = 0; d < 3; ++d) { ind[d] += box_begin[d]; }
+            f(ind) = *it;
+        }
+        const auto interp_refit = t.interpolate(f);
+        const double exact_dropped = t.update(interp_exact, box_begin, box);
+        const double dropped = t.update(interp_approx, box_begin, box, 1e-10);
+
+        double max_diff_exact{}, max_diff_approx{};
+        for (int i = 0; i < 2000; ++i) {
+            const double x = .5 * (rand_dist(rand_gen) + 1);
+            const double y = .5 * (rand_dist(rand_gen) + 1);
+            const double z = .5 * (rand_dist(rand_gen) + 1) * z_coords.back();
+            const double v = interp_refit(x, y, z);
+            max_diff_exact =
+                std::max(max_diff_exact, std::abs(interp_exact(x, y, z) - v));
+            max_diff_approx =
+                std::max(max_diff_approx, std::abs(interp_approx(x, y, z) - v));
+        }
+        assertion(max_diff_exact < 1e-12 && max_diff_approx < 1e-8 &&
+                  exact_dropped == 0 && dropped > 0 &&
+                  max_diff_approx <= dropped + 1e-12);
+        std::cout << "\nIncremental update test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ", max difference = " << max_diff_exact << " (exact), "
+                  << max_diff_approx << " (truncated, bounded by " << dropped
+                  << ")\n";
+
+        try {
+            t.update(interp_exact, {55, 0, 0}, box);
+            assertion(false, "Out of range box is accepted.");
+        } catch (const std::range_error&) {}
+
+        // periodic dimensions of even order, whose spline range starts half a
+        // grid spacing before the data grid
+        Mesh<double, 2> g({25, 25});
+        for (size_t i = 0; i < g.size(); ++i) {
+            *(g.data() + i) = rand_dist(rand_gen);
+        }
+        for (size_t i = 0; i < 25; ++i) {
+            g(i, 24) = g(i, 0);
+            g(24, i) = g(0, i);
+        }
+        const InterpolationFunctionTemplate<double, 2> t_even(
+            4, {true, true}, g.dimension(), std::make_pair(0., 1.),
+            std::make_pair(0., 1.));
+        auto interp_even = t_even.interpolate(g);
+        Mesh<double, 2> box_even({4, 4});
+        for (size_t i = 0; i < box_even.size(); ++i) {
+            *(box_even.data() + i) = rand_dist(rand_gen);
+        }
+        for (auto it = box_even.begin(); it != box_even.end(); ++it) {
+            const auto ind = box_even.iter_indices(it);
+            g(ind[0] + 10, ind[1] + 10) = *it;
+        }
+        const auto interp_even_refit = t_even.interpolate(g);
+        t_even.update(interp_even, {10, 10}, box_even);
+
+        double max_diff_even{};
+        for (int i = 0; i < 2000; ++i) {
+            const double x = .5 * (rand_dist(rand_gen) + 1);
+            const double y = .5 * (rand_dist(rand_gen) + 1);
+            max_diff_even =
+                std::max(max_diff_even, std::abs(interp_even(x, y) -
+                                                 interp_even_refit(x, y)));
+        }
+        assertion(max_diff_even < 1e-12);
+        std::cout << "Incremental update test of even order "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ", max difference = " << max_diff_even << '\n';
+    }
+
+    // out-of-core fitting, compared with in-memory one
+
+    {
+        std::mt19937 rand_gen(5);
+        std::uniform_real_distribution<> rand_dist(-1, 1);
+        Mesh<double, 3> f({33, 20, 17});
+        for (size_t i = 0; i < f.size(); ++i) {
+            *(f.data() + i) = rand_dist(rand_gen);
+        }
+        const std::string data_file = "out-of-core-test-data.bin";
+        const std::string ctrl_file = "out-of-core-test-ctrl.bin";
+        {
+            std::ofstream out(data_file, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(f.data()),
+                      static_cast<std::streamsize>(f.size() * sizeof(double)));
+        }
+
+        double max_diff{};
+        for (auto periodicity : {std::array<bool, 3>{false, false, false},
+                                 std::array<bool, 3>{true, false, true}}) {
+            const InterpolationFunctionTemplate<double, 3> t(
+                4, periodicity, f.dimension(), std::make_pair(0., 1.),
+                std::make_pair(0., 1.), std::make_pair(0., 1.));
+            const auto interp = t.interpolate(f);
+            // a budget of a few hyperplanes, so that there are several slabs
+            // and column blocks
+            t.interpolate_out_of_core(data_file, ctrl_file,
+                                      (1 << 18) + 5 * 20 * 17 * sizeof(double));
+            const auto interp_ooc = t.load(ctrl_file);
+            try {
+                // less than a hyperplane of both control points and data
+                t.interpolate_out_of_core(data_file, ctrl_file,
+                                          (1 << 18) + 600 * sizeof(double));
+                assertion(false, "Too small memory budget is accepted.");
+            } catch (const std::runtime_error&) {}
+            for (int i = 0; i < 1000; ++i) {
+                const double x = .5 * (rand_dist(rand_gen) + 1);
+                const double y = .5 * (rand_dist(rand_gen) + 1);
+                const double z = .5 * (rand_dist(rand_gen) + 1);
+                max_diff = std::max(
+                    max_diff, std::abs(interp(x, y, z) - interp_ooc(x, y, z)));
+            }
+        }
+        assertion(max_diff < 1e-14);
+        std::cout << "\nOut-of-core fitting test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ", max difference = " << max_diff << '\n';
+        std::remove(data_file.c_str());
+        std::remove(ctrl_file.c_str());
+    }
+
+    // batch fitting of many series, compared with fitting one by one
+
+    {
+        std::mt19937 rand_gen(11);
+        std::uniform_real_distribution<> rand_dist(-1, 1);
+        constexpr size_t series_num = 37;
+        constexpr size_t point_num = 50;
+        Mesh<double, 2> series({series_num, point_num});
+        for (size_t i = 0; i < series.size(); ++i) {
+            *(series.data() + i) = rand_dist(rand_gen);
+        }
+        double max_diff{};
+        for (bool periodic : {false, true}) {
+            if (periodic) {
+                for (size_t k = 0; k < series_num; ++k) {
+                    series(k, point_num - 1) = series(k, 0);
+                }
+            }
+            for (size_t order : {3, 4}) {
+                const InterpolationFunctionTemplate1D<> t(
+                    std::make_pair(0., 1.), point_num, order, periodic);
+                for (size_t thread_num : {1, 3}) {
+                    const auto collection =
+                        t.interpolate_batch(series, thread_num);
+                    assertion(collection.size() == series_num);
+                    for (size_t k = 0; k < series_num; ++k) {
+                        std::vector<double> row(point_num);
+                        for (size_t i = 0; i < point_num; ++i) {
+                            row[i] = series(k, i);
+                        }
+                        const auto interp = t.interpolate(
+                            std::make_pair(row.begin(), row.end()));
+                        const auto standalone = collection.function(k);
+                        for (int i = 0; i < 20; ++i) {
+                            const double x = .5 * (rand_dist(rand_gen) + 1);
+                            max_diff = std::max(
+                                {max_diff,
+                                 std::abs(collection(k, x) - interp(x)),
+                                 std::abs(standalone(x) - interp(x))});
+                        }
+                    }
+                }
+                try {
+                    const MeshDimension<2> short_dim(
+                        {series_num, point_num - 1});
+                    t.interpolate_batch(
+                        MeshView<const double, 2>(series.data(), short_dim));
+                    assertion(false, "Series of wrong length is accepted.");
+                } catch (const std::range_error&) {}
+            }
+        }
+        assertion(max_diff < 1e-14);
+        std::cout << "\nBatch fitting test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ", max difference = " << max_diff << '\n';
+    }
+
     return assertion.status();
 }
@@ -4,6 +4,8 @@
 
 #include <algorithm>
 #include <iostream>
+#include <iterator>  // back_inserter
+#include <vector>
 
 int main() {
     using namespace std;
@@ -135,6 +137,60 @@ int main() {
               << (assertion.last_status() == 0 ? "succeed" : "failed") << '\n';
     std::cout << "Relative Error = " << d << '\n';
 
+    {
+        // the same data in column-major order, as passed from MATLAB
+        Mesh<double, 2> f2d_col{MeshDimension<2>(
+            {f2.size(), f2[0].size()}, Layout::col_major)};
+        for (size_t j = 0; j < f2d_col.dim_size(1); ++j) {
+            for (size_t i = 0; i < f2d_col.dim_size(0); ++i) {
+                *(f2d_col.data() + i + j * f2d_col.dim_size(0)) = f2[i][j];
+            }
+        }
+        InterpolationFunction<double, 2> interp2_col{
+            3, f2d_col,
+            make_pair(0., static_cast<double>(f2d.dim_size(0)) - 1.),
+            make_pair(0., static_cast<double>(f2d.dim_size(1)) - 1.)};
+        double diff{};
+        for (const auto& c : coords_2d) {
+            diff = std::max(diff, std::abs(interp2_col(c) - interp2(c)));
+        }
+        assertion(diff == 0);
+        std::cout << "\n2D column-major input test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+
+        // a view of the data padded to a 7x6 row-major array, read in place
+        std::vector<double> padded(7 * 6, 100.);
+        for (size_t i = 0; i < f2d.dim_size(0); ++i) {
+            for (size_t j = 0; j < f2d.dim_size(1); ++j) {
+                padded[(i + 1) * 6 + j] = f2[i][j];
+            }
+        }
+        const MeshView<const double, 2> f2d_view{
+            padded.data() + 6,
+            MeshDimension<2>({f2d.dim_size(0), f2d.dim_size(1)}, {6, 1})};
+        InterpolationFunction<double, 2> interp2_view{
+            3, f2d_view,
+            make_pair(0., static_cast<double>(f2d.dim_size(0)) - 1.),
+            make_pair(0., static_cast<double>(f2d.dim_size(1)) - 1.)};
+        // a view of the column-major mesh
+        InterpolationFunctionTemplate<double, 2> interp2_template{
+            3, f2d_col.dimension(),
+            make_pair(0., static_cast<double>(f2d.dim_size(0)) - 1.),
+            make_pair(0., static_cast<double>(f2d.dim_size(1)) - 1.)};
+        auto interp2_col_view =
+            interp2_template.interpolate(MeshView<double, 2>{f2d_col});
+        diff = 0;
+        for (const auto& c : coords_2d) {
+            diff = std::max(diff, std::abs(interp2_view(c) - interp2(c)));
+            diff = std::max(diff, std::abs(interp2_col_view(c) - interp2(c)));
+        }
+        assertion(diff == 0);
+        std::cout << "\n2D mesh view input test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+    }
+
     try {
         interp2.at(-1, 1);
         assertion(false, "Out of boundary check failed.\n");
@@ -539,5 +595,510 @@ int main() {
               << (assertion.last_status() == 0 ? "succeed" : "failed") << '\n';
     std::cout << "Relative Error = " << d << '\n';
 
+    // integration test
+
+    std::cout << "\nIntegration Test:\n";
+
+    {
+        // A piecewise linear function can be integrated exactly by trapezoid
+        // rule.
+        auto trapezoid = [&](double a, double b) {
+            double sum{};
+            auto x_it = input_coords_1d.begin();
+            for (size_t i = 0; i < f.size() - 1; ++i, ++x_it) {
+                const double x0 = *x_it, x1 = *std::next(x_it);
+                const double l = std::max(a, x0), r = std::min(b, x1);
+                if (l >= r) { continue; }
+                auto lin = [&](double x) {
+                    return f[i] + (f[i + 1] - f[i]) * (x - x0) / (x1 - x0);
+                };
+                sum += .5 * (lin(l) + lin(r)) * (r - l);
+            }
+            return sum;
+        };
+        d = std::abs(interp1_nonuniform_linear.integrate(
+                         std::make_pair(.5, 9.7)) -
+                     trapezoid(.5, 9.7));
+        assertion(d < tol);
+        std::cout << "\n1D nonuniform integration test (linear) "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+        std::cout << "Error = " << d << '\n';
+
+        // Integral of uniform periodic spline over a period equals that given
+        // by trapezoid rule on interpolated points.
+        double sum{};
+        for (size_t i = 0; i < f.size() - 1; ++i) { sum += f[i]; }
+        const double period_integral = interp1_periodic.integrate();
+        d = std::abs(period_integral - sum);
+        assertion(d < tol);
+        d = std::abs(interp1_periodic.integrate(std::make_pair(-3.2, 29.1)) -
+                     interp1_periodic.integrate(std::make_pair(-3.2, 5.1)) -
+                     2 * period_integral);
+        assertion(d < 10 * tol);
+        std::cout << "\n1D periodic integration test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+        std::cout << "Error = " << d << '\n';
+
+        // Cubic spline reproduces cubic polynomial, so does its integral.
+        auto poly = [](double x, double y) {
+            return x * x * x - 2 * x * y * y + y + 1;
+        };
+        auto poly_integral = [](double x0, double x1, double y0, double y1) {
+            return (x1 * x1 * x1 * x1 - x0 * x0 * x0 * x0) / 4 * (y1 - y0) -
+                   (x1 * x1 - x0 * x0) * (y1 * y1 * y1 - y0 * y0 * y0) / 3 +
+                   (x1 - x0) * (y1 * y1 - y0 * y0) / 2 +
+                   (x1 - x0) * (y1 - y0);
+        };
+        Mesh<double, 2> poly_mesh(
+            {9, nonuniform_coord_for_2d.size()});
+        for (size_t i = 0; i < poly_mesh.dim_size(0); ++i) {
+            auto y_it = nonuniform_coord_for_2d.begin();
+            for (size_t j = 0; j < poly_mesh.dim_size(1); ++j, ++y_it) {
+                poly_mesh(i, j) = poly(.5 * static_cast<double>(i), *y_it);
+            }
+        }
+        InterpolationFunction<double, 2> interp2_poly(
+            3, poly_mesh, std::make_pair(0., 4.),
+            util::get_range(nonuniform_coord_for_2d));
+
+        d = std::abs(interp2_poly.integrate(std::make_pair(.3, 3.7),
+                                            std::make_pair(.5, 3.5)) -
+                     poly_integral(.3, 3.7, .5, 3.5)) /
+            std::abs(poly_integral(.3, 3.7, .5, 3.5));
+        assertion(d < tol);
+        d = std::abs(interp2_poly.integrate() - poly_integral(0, 4, 0, 4)) /
+            std::abs(poly_integral(0, 4, 0, 4));
+        assertion(d < tol);
+        std::cout << "\n2D nonuniform integration test (cubic) "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+        std::cout << "Relative Error = " << d << '\n';
+
+        // Quadratic spline reproduces quadratic polynomial.
+        std::vector<double> quad_vals;
+        for (size_t i = 0; i < 5; ++i) {
+            quad_vals.push_back(static_cast<double>(i * i));
+        }
+        InterpolationFunction1D<> interp1_quad(util::get_range(quad_vals), 2);
+        d = std::abs(interp1_quad.integrate() - 64. / 3) / (64. / 3);
+        assertion(d < tol);
+        std::cout << "\n1D integration test (quadratic) "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+        std::cout << "Relative Error = " << d << '\n';
+
+        try {
+            interp2_poly.integrate(std::make_pair(-1., 1.),
+                                   std::make_pair(0., 1.));
+            assertion(false, "Integration range check failed.\n");
+        } catch (const std::domain_error&) {
+            std::cout << "Integration range check succeed.\n";
+        }
+    }
+
+    // antiderivative test
+
+    std::cout << "\nAntiderivative Test:\n";
+
+    {
+        const auto interp1_primitive = interp1.antiderivative();
+        double err{};
+        for (auto x : coords_1d_half) {
+            err = std::max(
+                err, std::abs(interp1_primitive(x) -
+                              interp1.integrate(std::make_pair(0., x))));
+            err = std::max(
+                err,
+                std::abs(interp1_primitive.derivative_at(std::make_pair(x, 1)) -
+                         interp1(x)));
+        }
+        assertion(err < tol);
+        std::cout << "\n1D antiderivative test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+        std::cout << "Error = " << err << '\n';
+
+        const auto interp1_periodic_primitive =
+            interp1_periodic.antiderivative();
+        const auto& r = interp1_periodic.range(0);
+        err = std::abs(interp1_periodic_primitive(r.second) -
+                       interp1_periodic.integrate());
+        for (auto x : coords_1d) {
+            err = std::max(
+                err, std::abs(interp1_periodic_primitive(x) -
+                              interp1_periodic.integrate(
+                                  std::make_pair(r.first, x))));
+        }
+        assertion(err < 10 * tol);
+        std::cout << "\n1D periodic antiderivative test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+        std::cout << "Error = " << err << '\n';
+
+        // 3D function integrated along one dimension, compared with Simpson's
+        // rule, which is exact since knots are on the edges of sub-intervals.
+        const auto interp3_reduced = interp3.integrate_along(1, .5, 3.5);
+        err = 0;
+        for (auto& c : coords_3d) {
+            constexpr size_t n = 12;
+            constexpr double h = 3. / n;
+            double simpson{};
+            for (size_t i = 0; i < n; ++i) {
+                const double y = .5 + h * static_cast<double>(i);
+                simpson += h / 6 *
+                           (interp3(c[0], y, c[2]) +
+                            4 * interp3(c[0], y + .5 * h, c[2]) +
+                            interp3(c[0], y + h, c[2]));
+            }
+            err = std::max(err,
+                           std::abs(interp3_reduced(c[0], c[2]) - simpson));
+        }
+        err = std::max(
+            err, std::abs(interp3_reduced.integrate() -
+                          interp3.integrate(interp3.range(0),
+                                            std::make_pair(.5, 3.5),
+                                            interp3.range(2))));
+        assertion(err < tol);
+        std::cout << "\n3D integration along one dimension test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+        std::cout << "Error = " << err << '\n';
+    }
+
+    // derivative function test
+
+    std::cout << "\nDerivative Function Test:\n";
+
+    {
+        const auto interp2_x2_y1 = interp2.differentiate(2, 1);
+        d = rel_err(interp2_x2_y1, util::get_range(coords_2d),
+                    util::get_range(vals_2d_derivative_x2_y1));
+        assertion(d < tol);
+        std::cout << "\n2D derivative function (2,1) "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+        std::cout << "Relative Error = " << d << '\n';
+
+        const auto interp3_x1_y0_z3 = interp3.differentiate(1, 0, 3);
+        d = rel_err(interp3_x1_y0_z3, util::get_range(coords_3d),
+                    util::get_range(vals_3d_derivative_x1_y0_z3));
+        assertion(d < tol);
+        std::cout << "\n3D derivative function (1,0,3) "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+        std::cout << "Relative Error = " << d << '\n';
+
+        // periodic spline of even order, and derivative of a derivative
+        const auto interp1_periodic_d1 =
+            interp1_nonuniform_periodic.differentiate(1);
+        const auto interp1_periodic_d3 = interp1_periodic_d1.differentiate(2);
+        const auto interp2_mixed_d1_d1 =
+            interp2_X_periodic_Y_nonuniform.differentiate(1, 1);
+        double err{};
+        for (auto x : coords_1d) {
+            for (size_t n = 1; n < 4; n += 2) {
+                err = std::max(
+                    err, std::abs((n == 1 ? interp1_periodic_d1(x)
+                                          : interp1_periodic_d3(x)) -
+                                  interp1_nonuniform_periodic.derivative_at(
+                                      std::make_pair(x, n))));
+            }
+        }
+        for (auto& c : coords_2d) {
+            err = std::max(
+                err, std::abs(interp2_mixed_d1_d1(c) -
+                              interp2_X_periodic_Y_nonuniform.derivative_at(
+                                  c, 1, 1)));
+        }
+        assertion(err < tol);
+        std::cout << "\nPeriodic and nonuniform derivative function "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+        std::cout << "Error = " << err << '\n';
+
+        // derivative of order higher than spline order vanishes
+        const auto interp2_vanished = interp2.differentiate(4, 0);
+        err = 0;
+        for (auto& c : coords_2d) {
+            err = std::max(err, std::abs(interp2_vanished(c)));
+        }
+        assertion(err == 0);
+        std::cout << "\nVanished derivative function "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+    }
+
+    // inverse test
+
+    std::cout << "\nInverse Test:\n";
+
+    {
+        // monotone increasing, uniform, cubic
+        std::vector<double> g_inc, g_dec;
+        for (size_t i = 0; i < 21; ++i) {
+            const double x = .5 * static_cast<double>(i);
+            g_inc.push_back(x + .5 * std::sin(x));
+        }
+        for (auto x : input_coords_1d) { g_dec.push_back(-x * x * x - x); }
+        InterpolationFunction1D<> interp_inc(std::make_pair(0., 10.),
+                                             util::get_range(g_inc));
+        // monotone decreasing, nonuniform, quadratic and linear
+        InterpolationFunction1D<> interp_dec(util::get_range(input_coords_1d),
+                                             util::get_range(g_dec), 2);
+        InterpolationFunction1D<> interp_dec_linear(
+            util::get_range(input_coords_1d), util::get_range(g_dec), 1);
+
+        double err{};
+        std::vector<double> ys_inc, ys_dec;
+        for (size_t i = 0; i <= 100; ++i) {
+            const double r = static_cast<double>((i * 37) % 101) / 100.;
+            ys_inc.push_back(g_inc.front() +
+                             r * (g_inc.back() - g_inc.front()));
+            ys_dec.push_back(g_dec.front() +
+                             r * (g_dec.back() - g_dec.front()));
+        }
+        for (auto y : ys_inc) {
+            err = std::max(err,
+                           std::abs(interp_inc(interp_inc.inverse(y)) - y));
+        }
+        // relative error for values of large magnitude
+        const double scale = std::abs(g_dec.back());
+        for (auto y : ys_dec) {
+            err = std::max(
+                err, std::abs(interp_dec(interp_dec.inverse(y)) - y) / scale);
+            err = std::max(
+                err, std::abs(interp_dec_linear(interp_dec_linear.inverse(y)) -
+                              y) /
+                         scale);
+        }
+        assertion(err < tol);
+        std::cout << "\n1D inverse test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+        std::cout << "Error = " << err << '\n';
+
+        // batch inverse, of sorted and unsorted values
+        std::vector<double> xs(ys_inc.size());
+        err = 0;
+        interp_inc.inverse(ys_inc.begin(), ys_inc.end(), xs.begin());
+        for (size_t i = 0; i < xs.size(); ++i) {
+            err = std::max(err,
+                           std::abs(xs[i] - interp_inc.inverse(ys_inc[i])));
+        }
+        std::sort(ys_inc.begin(), ys_inc.end());
+        interp_inc.inverse(ys_inc.begin(), ys_inc.end(), xs.begin());
+        for (size_t i = 0; i < xs.size(); ++i) {
+            err = std::max(err, std::abs(interp_inc(xs[i]) - ys_inc[i]));
+        }
+        assertion(err < tol);
+        std::cout << "\n1D batch inverse test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+        std::cout << "Error = " << err << '\n';
+
+        // inverse function built on samples
+        const auto interp_inc_inverse = interp_inc.inverse_function(201);
+        err = 0;
+        for (size_t i = 0; i < 100; ++i) {
+            // away from sample points
+            const double r = (static_cast<double>(i) + .37) / 100.;
+            const double y =
+                g_inc.front() + r * (g_inc.back() - g_inc.front());
+            err = std::max(err, std::abs(interp_inc_inverse(y) -
+                                         interp_inc.inverse(y)));
+        }
+        assertion(err < 1e-5);
+        std::cout << "\n1D inverse function test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+        std::cout << "Error = " << err << '\n';
+
+        // non-monotone periodic function, one of the solutions is found
+        err = 0;
+        for (auto x : coords_1d) {
+            const double y = interp1_periodic(x);
+            err = std::max(
+                err, std::abs(interp1_periodic(interp1_periodic.inverse(y)) -
+                              y));
+        }
+        assertion(err < tol);
+        std::cout << "\n1D periodic inverse test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+        std::cout << "Error = " << err << '\n';
+
+        try {
+            interp_inc.inverse(g_inc.back() + 1.);
+            assertion(false, "Inverse range check failed.\n");
+        } catch (const std::domain_error&) {
+            std::cout << "Inverse range check succeed.\n";
+        }
+        try {
+            interp_inc.inverse_function(3);
+            assertion(false, "Inverse sample number check failed.\n");
+        } catch (const std::domain_error&) {
+            std::cout << "Inverse sample number check succeed.\n";
+        }
+    }
+
+    // pipelined batch evaluation test
+
+    {
+        bool equal = true;
+        for (size_t lookahead : {size_t{0}, size_t{1}, size_t{3}, size_t{20}}) {
+            array<double, coords_3d.size()> vals3;
+            interp3.evaluate(coords_3d.begin(), coords_3d.end(), vals3.begin(),
+                             lookahead);
+            for (size_t i = 0; i < coords_3d.size(); ++i) {
+                equal = equal && vals3[i] == interp3(coords_3d[i]);
+            }
+            // periodic dimension and points out of range
+            vector<array<double, 2>> pts2(coords_2d.begin(), coords_2d.end());
+            pts2.push_back({-1., 9.5});
+            pts2.push_back({6., -3.});
+            vector<double> vals2;
+            interp2_periodic.evaluate(pts2.begin(), pts2.end(),
+                                      back_inserter(vals2), lookahead);
+            equal = equal && vals2.size() == pts2.size();
+            for (size_t i = 0; i < pts2.size(); ++i) {
+                equal = equal && vals2[i] == interp2_periodic(pts2[i]);
+            }
+        }
+        assertion(equal);
+        std::cout << "\nBatch evaluation test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+    }
+
+    // partially bound function test
+
+    {
+        double diff{};
+        for (const auto& c : coords_3d) {
+            for (size_t d = 0; d < 3; ++d) {
+                array<double, 2> rest;
+                for (size_t d_ = 0, r = 0; d_ < 3; ++d_) {
+                    if (d_ != d) { rest[r++] = c[d_]; }
+                }
+                diff = std::max(diff,
+                                std::abs(interp3.bind(d, c[d])(rest) -
+                                         interp3(c)));
+            }
+            diff = std::max(
+                diff, std::abs(interp3.bind<2>({2, 0}, {c[2], c[0]})(c[1]) -
+                               interp3(c)));
+        }
+        for (auto c : coords_2d) {
+            // bound out of the periodic range
+            c[1] += 4.;
+            diff = std::max(
+                diff, std::abs(interp2_periodic.bind(1, c[1])(c[0]) -
+                               interp2_periodic(c)));
+            diff = std::max(
+                diff, std::abs(interp2_periodic.bind(0, c[0])(c[1]) -
+                               interp2_periodic(c)));
+        }
+        assertion(diff < tol);
+        std::cout << "\nPartially bound function test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ", max difference = " << diff << '\n';
+
+        try {
+            interp3.bind<2>({1, 1}, {0., 0.});
+            assertion(false, "Binding a dimension twice is accepted.\n");
+        } catch (const std::domain_error&) {}
+        try {
+            interp3.bind(3, 0.);
+            assertion(false, "Binding a nonexistent dimension is accepted.\n");
+        } catch (const std::range_error&) {}
+
+        // slices through grid lines reproduce the data there
+        diff = 0;
+        const auto slice = interp2.slice(0, 2.);
+        for (size_t j = 0; j < f2d.dim_size(1); ++j) {
+            diff = std::max(diff, std::abs(slice(static_cast<double>(j)) -
+                                           f2d(2, j)));
+        }
+        for (const auto& c : coords_3d) {
+            const auto slice_3d = interp3.slice(1, c[1]);
+            diff = std::max(diff,
+                            std::abs(slice_3d(c[0], c[2]) - interp3(c)));
+        }
+        assertion(diff < tol);
+        std::cout << "\nSlice test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ", max difference = " << diff << '\n';
+
+        try {
+            interp2.slice(1, -.5);
+            assertion(false, "Slice out of range is accepted.\n");
+        } catch (const std::domain_error&) {}
+    }
+
+    // spline collection test
+
+    {
+        double diff{};
+        // periodic dimension of even order has one more knot
+        for (size_t order : {3, 4}) {
+            InterpolationFunctionTemplate<double, 2> interp2_template{
+                order, {false, true}, f2d.dimension(),
+                make_pair(0., static_cast<double>(f2d.dim_size(0)) - 1.),
+                make_pair(0., static_cast<double>(f2d.dim_size(1)) - 1.)};
+            vector<Mesh<double, 2>> fields(5, f2d);
+            vector<InterpolationFunction<double, 2>> interps;
+            for (size_t k = 0; k < fields.size(); ++k) {
+                for (size_t i = 0; i < f2d.size(); ++i) {
+                    *(fields[k].data() + i) += static_cast<double>(k * i % 7);
+                }
+                interps.push_back(interp2_template.interpolate(fields[k]));
+            }
+            for (auto layout :
+                 {CollectionLayout::planar, CollectionLayout::interleaved}) {
+                const SplineCollection<double, 2> collection(
+                    interp2_template, fields.begin(), fields.end(), layout);
+                // re-laid out from the other layout
+                const SplineCollection<double, 2> converted(
+                    collection.geometry(), collection.control_points(),
+                    layout == CollectionLayout::planar
+                        ? CollectionLayout::interleaved
+                        : CollectionLayout::planar);
+                assertion(collection.size() == fields.size() &&
+                          collection.layout() == layout &&
+                          (collection.control_points().dimension().stride(0) ==
+                           1) == (layout == CollectionLayout::interleaved));
+                const vector<size_t> subset{4, 1, 3};
+                for (auto c : coords_2d) {
+                    // out of the periodic range
+                    c[1] += 4.;
+                    vector<double> all, all_converted, part;
+                    collection.evaluate(c, back_inserter(all));
+                    converted.evaluate(c, back_inserter(all_converted));
+                    collection.evaluate(c, subset.begin(), subset.end(),
+                                        back_inserter(part));
+                    for (size_t k = 0; k < fields.size(); ++k) {
+                        const double v = interps[k](c);
+                        diff = std::max(
+                            {diff, std::abs(collection(k, c) - v),
+                             std::abs(collection(k, c[0], c[1]) - v),
+                             std::abs(all[k] - v),
+                             std::abs(all_converted[k] - v),
+                             std::abs(collection.function(k)(c) - v)});
+                    }
+                    for (size_t i = 0; i < subset.size(); ++i) {
+                        diff = std::max(
+                            diff, std::abs(part[i] - interps[subset[i]](c)));
+                    }
+                }
+            }
+        }
+        assertion(diff < tol);
+        std::cout << "\nSpline collection test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ", max difference = " << diff << '\n';
+    }
+
     return assertion.status();
 }
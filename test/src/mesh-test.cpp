@@ -114,5 +114,59 @@ int main() {
     assertion(mesh_4d.size() == util::pow(5u, 4u),
               "Equal length on each dimension mesh size wrong.");
 
+    // test column-major and strided layout
+
+    Mesh<int, 3> mesh_col{MeshDimension<3>({4, 5, 6}, Layout::col_major)};
+    assertion(mesh_col.dimension().stride(0) == 1 &&
+                  mesh_col.dimension().stride(1) == 4 &&
+                  mesh_col.dimension().stride(2) == 20 &&
+                  mesh_col.size() == 120,
+              "Column-major strides wrong.");
+    mesh_col(1, 2, 3) = 7;
+    assertion(*(mesh_col.data() + 1 + 2 * 4 + 3 * 20) == 7,
+              "Modify column-major data by index failed.");
+    auto col_it = mesh_col.begin();
+    advance(col_it, 1 + 2 * 4 + 3 * 20);
+    indices = mesh_col.iter_indices(col_it);
+    assertion(indices[0] == 1 && indices[1] == 2 && indices[2] == 3,
+              "Column-major iterator indexing failed.");
+    dim_it = mesh_col.begin(2, {1, 2, 0});
+    assertion(dim_it[3] == 7 &&
+                  mesh_col.end(2, {1, 2, 0}) - dim_it ==
+                      static_cast<std::ptrdiff_t>(mesh_col.dim_size(2)),
+              "Column-major dimension-wise iterator failed.");
+    mesh_col.resize({2, 3, 4});
+    assertion(mesh_col.dimension().layout() == Layout::col_major &&
+                  mesh_col.dimension().stride(2) == 6,
+              "Layout is not kept after resize.");
+
+    // a 3x4 sub-array of a 5x8 row-major array, starting at (1, 2)
+    const MeshDimension<2> sub_dim({3, 4}, {8, 1});
+    assertion(sub_dim.layout() == Layout::strided && sub_dim.size() == 12 &&
+                  sub_dim.extent() == 2 * 8 + 3 + 1,
+              "Strided mesh dimension size wrong.");
+    auto sub_indices = sub_dim.dimwise_indices(sub_dim.indexing(2, 3));
+    assertion(sub_indices[0] == 2 && sub_indices[1] == 3,
+              "Strided indexing failed.");
+
+    // test mesh view
+
+    std::vector<int> buffer(5 * 8);
+    for (unsigned i = 0; i < buffer.size(); ++i) {
+        buffer[i] = static_cast<int>(i);
+    }
+    MeshView<int, 2> sub_view(buffer.data() + 1 * 8 + 2, sub_dim);
+    sub_view(2, 3) = -1;
+    assertion(buffer[3 * 8 + 5] == -1 && sub_view(0, 1) == 11,
+              "Mesh view element access failed.");
+    const MeshView<const int, 2> const_view = sub_view;
+    const Mesh<int, 2> sub_mesh(const_view);
+    assertion(sub_mesh.size() == 12 && sub_mesh(1, 2) == 20 &&
+                  sub_mesh.dimension().layout() == Layout::row_major,
+              "Copy from mesh view failed.");
+    const MeshView<const int, 3> col_view(mesh_col);
+    assertion(&col_view(1, 2, 3) == &mesh_col(1, 2, 3),
+              "View of mesh failed.");
+
     return assertion.status();
 }
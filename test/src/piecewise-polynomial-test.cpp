@@ -0,0 +1,168 @@
+#include <Interpolation.hpp>
+#include "include/Assertion.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// M_PI is not part of the standard
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+template <typename F1, typename F2, typename Coords>
+double max_abs_err(const F1& f1, const F2& f2, const Coords& coords) {
+    double err{};
+    for (auto& c : coords) { err = std::max(err, std::abs(f1(c) - f2(c))); }
+    return err;
+}
+
+int main() {
+    using namespace intp;
+
+    Assertion assertion;
+    constexpr double tol = 1e-12;
+
+    std::mt19937 rand_gen(42);
+    std::uniform_real_distribution<> rand_dist(0, 1);
+
+    // data to be interpolated
+
+    constexpr size_t n = 17;
+    std::vector<double> f1d;
+    Mesh<double, 2> f2d{n, n - 4};
+    Mesh<double, 3> f3d{n - 6, n - 8, n - 4};
+    for (size_t i = 0; i < n; ++i) {
+        f1d.push_back(std::sin(2 * M_PI * static_cast<double>(i) / (n - 1)) +
+                      rand_dist(rand_gen));
+    }
+    for (size_t i = 0; i < f2d.size(); ++i) {
+        *(f2d.data() + i) = rand_dist(rand_gen);
+    }
+    for (size_t i = 0; i < f3d.size(); ++i) {
+        *(f3d.data() + i) = rand_dist(rand_gen);
+    }
+
+    std::vector<double> nonuniform_coord{0.};
+    for (size_t i = 1; i < n; ++i) {
+        nonuniform_coord.push_back(nonuniform_coord.back() + .5 +
+                                   rand_dist(rand_gen));
+    }
+
+    // random sample points, some of them out of range
+
+    std::vector<double> coords_1d;
+    std::vector<std::array<double, 2>> coords_2d;
+    std::vector<std::array<double, 3>> coords_3d;
+    for (size_t i = 0; i < 100; ++i) {
+        coords_1d.push_back(1.2 * rand_dist(rand_gen) - .1);
+        coords_2d.push_back({1.2 * rand_dist(rand_gen) - .1,
+                             1.2 * rand_dist(rand_gen) - .1});
+        coords_3d.push_back({1.2 * rand_dist(rand_gen) - .1,
+                             1.2 * rand_dist(rand_gen) - .1,
+                             1.2 * rand_dist(rand_gen) - .1});
+    }
+
+    // 1D
+
+    for (size_t order = 1; order < 6; ++order) {
+        for (bool periodic : {false, true}) {
+            const InterpolationFunction1D<> interp(
+                std::make_pair(0., 1.), util::get_range(f1d), order, periodic);
+            const auto pp = interp.pp_form();
+            const double err = max_abs_err(
+                interp, [&](double x) { return pp(x); }, coords_1d);
+            assertion(err < tol);
+            std::cout << "\n1D pp-form test (order " << order
+                      << (periodic ? ", periodic) " : ") ")
+                      << (assertion.last_status() == 0 ? "succeed" : "failed")
+                      << '\n';
+            std::cout << "Error = " << err << '\n';
+        }
+    }
+
+    {
+        const InterpolationFunction1D<> interp(
+            util::get_range(nonuniform_coord), util::get_range(f1d), 4, true);
+        const auto pp = interp.pp_form();
+        std::vector<double> coords;
+        for (auto x : coords_1d) {
+            coords.push_back(x * nonuniform_coord.back());
+        }
+        const double err =
+            max_abs_err(interp, [&](double x) { return pp(x); }, coords);
+        assertion(err < tol);
+        std::cout << "\n1D nonuniform periodic pp-form test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+        std::cout << "Error = " << err << '\n';
+    }
+
+    // 2D, x-periodic and y-nonuniform
+
+    {
+        std::vector<double> y_coord(nonuniform_coord.begin(),
+                                    nonuniform_coord.begin() + n - 4);
+        const InterpolationFunction<double, 2> interp(
+            3, {true, false}, f2d, std::make_pair(0., 1.),
+            util::get_range(y_coord));
+        const auto pp = interp.pp_form();
+        std::vector<std::array<double, 2>> coords;
+        for (auto c : coords_2d) {
+            coords.push_back({c[0], c[1] * y_coord.back()});
+        }
+        const double err = max_abs_err(
+            interp, [&](std::array<double, 2> c) { return pp(c); }, coords);
+        assertion(err < tol);
+        std::cout << "\n2D pp-form test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+        std::cout << "Error = " << err << '\n';
+    }
+
+    // 3D, with different order in each dimension
+
+    {
+        const InterpolationFunction<double, 3> interp(
+            5, {false, true, false}, f3d, std::make_pair(0., 1.),
+            std::make_pair(0., 1.), std::make_pair(0., 1.));
+        const auto interp_deri = interp.differentiate(1, 0, 3);
+        const auto pp = interp_deri.pp_form();
+        // derivative values are large, use relative error instead
+        double scale{};
+        for (auto& c : coords_3d) {
+            scale = std::max(scale, std::abs(interp_deri(c)));
+        }
+        const double err =
+            max_abs_err(interp_deri,
+                        [&](std::array<double, 3> c) { return pp(c); },
+                        coords_3d) /
+            scale;
+        assertion(err < tol);
+        std::cout << "\n3D pp-form test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << '\n';
+        std::cout << "Error = " << err << '\n';
+        assertion(pp.dim_order(0) == 4 && pp.dim_order(1) == 5 &&
+                      pp.dim_order(2) == 2,
+                  "3D pp-form order check failed.");
+    }
+
+    // out of range check
+
+    {
+        const InterpolationFunction1D<> interp(std::make_pair(0., 1.),
+                                               util::get_range(f1d));
+        const auto pp = interp.pp_form();
+        try {
+            pp.at(1.1);
+            assertion(false, "pp-form range check failed.\n");
+        } catch (const std::domain_error&) {
+            std::cout << "\npp-form range check succeed.\n";
+        }
+    }
+
+    return assertion.status();
+}
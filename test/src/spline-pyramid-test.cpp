@@ -0,0 +1,145 @@
+#include <SplinePyramid.hpp>
+#include "include/Assertion.hpp"
+
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// M_PI is not part of the standard
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+int main() {
+    using namespace intp;
+
+    Assertion assertion;
+
+    // smooth function, periodic in the second dimension
+    const std::size_t nx = 257, ny = 129;
+    Mesh<double, 2> mesh({nx, ny});
+    for (std::size_t i = 0; i < nx; ++i) {
+        for (std::size_t j = 0; j < ny; ++j) {
+            const double x = static_cast<double>(i) / (nx - 1);
+            const double y = 2 * M_PI * static_cast<double>(j) / (ny - 1);
+            mesh(i, j) = std::exp(-x) * std::cos(3 * y);
+        }
+    }
+    const InterpolationFunction<double, 2> f(
+        3, {false, true}, mesh, std::make_pair(0., 1.),
+        std::make_pair(0., 2 * M_PI));
+
+    const SplinePyramid<double, 2> pyramid(f);
+
+    // levels and error estimates
+
+    {
+        // the periodic dimension stops halving at 9 points
+        assertion(pyramid.size() == 6 && pyramid.error(0) == 0.,
+                  "Wrong number of pyramid levels.");
+        assertion(pyramid.spacing(1, 0) == 2 * pyramid.spacing(0, 0) &&
+                      pyramid.spacing(pyramid.size() - 1, 1) ==
+                          pyramid.spacing(pyramid.size() - 2, 1),
+                  "Wrong grid spacing of pyramid levels.");
+
+        std::mt19937 rand_gen(3);
+        std::uniform_real_distribution<> rand_dist(0., 1.);
+        bool estimated = true;
+        for (std::size_t l = 0; l < pyramid.size(); ++l) {
+            if (l > 0) {
+                estimated =
+                    estimated && pyramid.error(l) >= pyramid.error(l - 1);
+            }
+            double err{};
+            for (int i = 0; i < 1000; ++i) {
+                const std::array<double, 2> c{rand_dist(rand_gen),
+                                              8 * rand_dist(rand_gen)};
+                err = std::max(err, std::abs(pyramid.level(l)(c) - f(c)));
+            }
+            // measured on a grid finer than the level itself
+            estimated = estimated && err <= 2 * pyramid.error(l) + 1e-14;
+            std::cout << "Level " << l << ": error estimate "
+                      << pyramid.error(l) << ", sampled error " << err
+                      << '\n';
+        }
+        assertion(estimated);
+        std::cout << "\nPyramid error estimate test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ".\n";
+    }
+
+    // level selection
+
+    {
+        bool selected = true;
+        for (double tol : {0., 1e-8, 1e-6, 1e-4, 1.}) {
+            const std::size_t l = pyramid.level_for_tolerance(tol);
+            selected = selected && pyramid.error(l) <= tol &&
+                       (l + 1 == pyramid.size() || pyramid.error(l + 1) > tol);
+        }
+        selected = selected && pyramid.level_for_tolerance(1.) ==
+                                   pyramid.size() - 1;
+        const double dx = pyramid.spacing(0, 0);
+        selected = selected && pyramid.level_for_footprint({dx, 1.}) == 0 &&
+                   pyramid.level_for_footprint({4.5 * dx, 1.}) == 2 &&
+                   &pyramid.for_footprint({4.5 * dx, 1.}) == &pyramid.level(2);
+        assertion(selected);
+        std::cout << "\nPyramid level selection test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ".\n";
+    }
+
+    // periodic dimension of even order
+
+    {
+        const std::size_t n = 33;
+        std::vector<double> vals(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            vals[i] = std::sin(2 * M_PI * static_cast<double>(i) / (n - 1));
+        }
+        const InterpolationFunction1D<> g(std::make_pair(0., 1.),
+                                          util::get_range(vals), 2, true);
+        const SplinePyramid<double, 1> periodic_pyramid(g);
+        // 33, 17, 9 points
+        assertion(periodic_pyramid.size() == 3 &&
+                      std::abs(periodic_pyramid.spacing(0, 0) - 1. / 32) <
+                          1e-15 &&
+                      std::abs(periodic_pyramid.spacing(2, 0) - 1. / 8) <
+                          1e-15,
+                  "Wrong grid of periodic pyramid of even order.");
+        // coarse levels pass through the original function at their nodes
+        double diff{};
+        for (std::size_t l = 1; l < periodic_pyramid.size(); ++l) {
+            const double dx = periodic_pyramid.spacing(l, 0);
+            for (double x = 0; x < 1; x += dx) {
+                diff = std::max(
+                    diff, std::abs(periodic_pyramid.level(l)(x) - g(x)));
+            }
+        }
+        assertion(diff < 1e-12);
+        std::cout << "\nPeriodic even order pyramid test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ".\n";
+    }
+
+    // nonuniform grid is rejected
+
+    {
+        std::vector<double> xs, vals;
+        for (int i = 0; i < 40; ++i) {
+            xs.push_back(i + .01 * i * i);
+            vals.push_back(std::sin(.1 * i));
+        }
+        try {
+            SplinePyramid<double, 1> nonuniform(
+                InterpolationFunction1D<>(util::get_range(xs),
+                                          util::get_range(vals)));
+            assertion(false, "Nonuniform grid is accepted.");
+        } catch (const std::domain_error&) {}
+    }
+
+    return assertion.status();
+}
@@ -0,0 +1,113 @@
+#include <Interpolation.hpp>
+#include <ThreadPool.hpp>
+#include "include/Assertion.hpp"
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+int main() {
+    using namespace intp;
+
+    Assertion assertion;
+
+    Mesh<double, 3> mesh({40, 30, 20});
+    for (std::size_t i = 0; i < mesh.size(); ++i) {
+        *(mesh.data() + i) = std::sin(.01 * static_cast<double>(i));
+    }
+    const InterpolationFunction<double, 3> interp(
+        3, {false, true, false}, mesh, std::make_pair(0., 1.),
+        std::make_pair(0., 1.), std::make_pair(0., 1.));
+
+    // points of uneven cost, a quarter of them out of range
+    std::vector<std::array<double, 3>> points;
+    {
+        std::mt19937 rand_gen(1);
+        std::uniform_real_distribution<> rand_dist(-.25, 1.);
+        for (int i = 0; i < 100000; ++i) {
+            points.push_back(
+                {rand_dist(rand_gen), rand_dist(rand_gen), rand_dist(rand_gen)});
+        }
+    }
+    std::vector<double> expected;
+    for (const auto& p : points) { expected.push_back(interp(p)); }
+
+    // every index is visited exactly once
+
+    {
+        ThreadPool pool(4, true);
+        std::vector<std::atomic<int>> visits(10007);
+        for (auto& v : visits) { v = 0; }
+        parallel_for(
+            visits.size(),
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) { ++visits[i]; }
+            },
+            pool, 16);
+        bool once = true;
+        for (auto& v : visits) { once = once && v == 1; }
+        assertion(once);
+        std::cout << "\nParallel for test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ".\n";
+    }
+
+    // parallel evaluation on thread pool and user-supplied executors
+
+    {
+        ThreadPool pool(4);
+        std::vector<double> vals(points.size());
+        parallel_evaluate(interp, points.begin(), points.end(), vals.begin(),
+                          pool);
+        bool equal = vals == expected;
+
+        // running tasks inline
+        std::fill(vals.begin(), vals.end(), 0.);
+        parallel_evaluate(
+            interp, points.begin(), points.end(), vals.begin(),
+            [](std::function<void()> task) { task(); }, 8);
+        equal = equal && vals == expected;
+
+        // a thread for each task
+        std::vector<std::thread> threads;
+        std::fill(vals.begin(), vals.end(), 0.);
+        parallel_evaluate(
+            interp, points.begin(), points.end(), vals.begin(),
+            [&](std::function<void()> task) {
+                threads.emplace_back(std::move(task));
+            },
+            6, 64);
+        for (auto& t : threads) { t.join(); }
+        equal = equal && vals == expected;
+
+        assertion(equal);
+        std::cout << "\nParallel evaluation test "
+                  << (assertion.last_status() == 0 ? "succeed" : "failed")
+                  << ".\n";
+    }
+
+    // exception thrown in a chunk is rethrown to the caller
+
+    {
+        ThreadPool pool(3);
+        try {
+            parallel_for(
+                1000,
+                [](std::size_t begin, std::size_t end) {
+                    if (begin <= 500 && 500 < end) {
+                        throw std::runtime_error("Chunk failed.");
+                    }
+                },
+                pool, 10);
+            assertion(false, "Exception in chunk is not propagated.");
+        } catch (const std::runtime_error&) {}
+    }
+
+    return assertion.status();
+}